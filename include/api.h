@@ -1,15 +1,63 @@
 #ifndef API_H
 #define API_H
 #include <Arduino.h>
-#include <vector>
+#include <time.h>
 
+#define MAX_TRAMS 10           // Departures collected per fetch
+#define DEPARTURE_WINDOW_MIN 60  // Board shows departures this many minutes ahead
+
+// One departure: interned line/destination ids plus an absolute time, so
+// the countdown can be recomputed locally at any moment
 struct Tram {
-    String line;
-    String dest;
-    int mins;
+    uint8_t line;
+    uint8_t dest;
+    uint32_t departs;  // Departure time, Unix epoch seconds
+};
+
+// Fixed-capacity departure list, filled in place by fetchTrams()
+struct DepartureTable {
+    Tram trams[MAX_TRAMS];
+    uint8_t count;
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    const Tram& operator[](size_t i) const { return trams[i]; }
+};
+
+const char* tramLine(const Tram& t);
+const char* tramDest(const Tram& t);
+
+// Whole minutes from now until the departure (negative once it has left)
+int tramMinutes(const Tram& t, time_t now);
+int minutesUntil(time_t departs, time_t now);
+
+// Drop departures that have already left
+void pruneDeparted(DepartureTable& table, time_t now);
+
+// A stop on the board. Filters are applied while parsing, so rows that do
+// not match are never stored; nullptr means no filter. The time window is
+// not: it moves with the clock, so it is applied when stops are merged.
+struct StopConfig {
+    const char* code;  // DRGL stop code, e.g. "NL:S:32000903"
+    const char* line;  // Only this line number
+    const char* dest;  // Only destinations containing this text
 };
 
-std::vector<Tram> fetchTrams();
+// Which stages of a fetch actually had new input
+enum FetchResult : uint8_t {
+    FETCH_FAILED,        // Table kept, departed trams dropped
+    FETCH_NOT_MODIFIED,  // Server answered 304; table kept
+    FETCH_UNCHANGED,     // Same departures as last time; table kept
+    FETCH_UPDATED        // Table rebuilt from the page
+};
+
+// Fetch every configured stop and merge them into one time-ordered table
+FetchResult fetchTrams(DepartureTable& table);
+// Free interned names that neither the stop tables nor the board on screen
+// use any more. Only while the network task is idle: it interns and the
+// sweep moves the strings.
+void reclaimTramStrings(const DepartureTable& shown);
+
 int getLastHttpCode();
 int getLastHtmlSize();
 int getLastFoundEntries();
@@ -0,0 +1,49 @@
+#ifndef BAND_CANVAS_H
+#define BAND_CANVAS_H
+#include <Adafruit_GFX.h>
+#include <Adafruit_SPITFT.h>
+#include "config.h"
+
+// Off-screen RGB565 band for composing part of the screen in RAM.
+// Drawing uses screen coordinates; anything outside the current window
+// is clipped. flush() sends the window as one SPI transfer instead of a
+// transaction per glyph and line.
+//
+// flush() blocks: on the ESP32 core writePixels feeds the SPI FIFO from the
+// CPU, and the C3 has a single core. Nothing runs in parallel with a
+// transfer; the network task only gets the CPU when the scheduler
+// preempts the render between or during bands. The gain is fewer
+// transactions, not overlap.
+
+#define BAND_PIXELS (160 * DISPLAY_BAND_LINES)
+
+class BandCanvas : public Adafruit_GFX {
+public:
+    BandCanvas(int16_t screenW, int16_t screenH) : Adafruit_GFX(screenW, screenH) {}
+
+    // Point the band at a screen rectangle; w * h must fit in BAND_PIXELS
+    void setWindow(int16_t x, int16_t y, uint16_t w, uint16_t h);
+
+    void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+    void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+    void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+    void fillScreen(uint16_t color) override;
+
+    // Send the window to the same rectangle on the display
+    void flush(Adafruit_SPITFT& display);
+    // Send the window to a rectangle of the same size at x, y
+    void flush(Adafruit_SPITFT& display, int16_t x, int16_t y);
+
+    int16_t windowX() const { return wx; }
+    int16_t windowY() const { return wy; }
+    uint16_t windowW() const { return ww; }
+    uint16_t windowH() const { return wh; }
+
+private:
+    uint16_t buffer[BAND_PIXELS];
+    int16_t wx = 0, wy = 0;
+    uint16_t ww = 0, wh = 0;
+};
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef CLOCK_KEEPER_H
+#define CLOCK_KEEPER_H
+#include <Arduino.h>
+
+// Wall clock that is usable right after a reset. The last known time is
+// copied to RTC memory every few seconds; that memory survives software,
+// panic and watchdog resets (not power loss), so the clock is put back
+// on boot and SNTP only corrects it later. The oscillator's drift against
+// SNTP is measured on every sync, kept in NVS, and sets how often SNTP
+// has to resync.
+
+enum ClockSource : uint8_t {
+    CLOCK_NONE,      // Not set yet: power-on without RTC data, SNTP pending
+    CLOCK_RESTORED,  // Carried over a reset, off by a few seconds at most
+    CLOCK_SNTP       // Set by SNTP
+};
+
+// First thing in setup(): time zone rule and the restored clock
+void beginClock();
+// Start SNTP; call once the network is up
+void startClockSync();
+// SNTP just set the clock
+void clockSynced();
+// Refresh the RTC copy; call from loop()
+void tickClock();
+
+ClockSource getClockSource();
+float getClockDriftPpm();
+
+#endif
@@ -3,9 +3,88 @@
 
 #define WIFI_SSID "Ceviche2"
 #define WIFI_PASSWORD "CapitanoAmericano55"
-#define STOP_CODE "NL:S:32000903"
+#define WIFI_FAST_CONNECT 1          // Reconnect with the BSSID, channel and lease saved in flash
+#define WIFI_REUSE_LEASE 1           // Fast connects skip DHCP and reuse the last address
+#define WIFI_LEASE_REUSE_S 43200     // ...for this long after DHCP gave it, half a common 24 h lease
+#define WIFI_FAST_TIMEOUT_MS 3000    // Scan instead when the fast path has not connected by then
+#define WIFI_CONNECT_TIMEOUT_MS 20000
+#define WIFI_BACKOFF_MIN_MS 2000     // First wait after a failed connect, doubled each time
+#define WIFI_BACKOFF_MAX_MS 60000
+#define WIFI_STATIC_IP ""            // e.g. "192.168.1.50"; empty = DHCP
+#define WIFI_STATIC_GATEWAY ""
+#define WIFI_STATIC_SUBNET "255.255.255.0"
+#define WIFI_STATIC_DNS ""           // Empty = the gateway
+
+// Clock: local time zone and how SNTP keeps it
+#define TIME_ZONE "CET-1CEST,M3.5.0,M10.5.0/3"  // Europe/Amsterdam, with DST
+#define CLOCK_RTC_SAVE_INTERVAL 10000   // Time copied to RTC memory this often
+#define CLOCK_MAX_ERROR_MS 500          // Drift allowed to build up between SNTP syncs
+#define CLOCK_SYNC_MIN_INTERVAL 900000  // SNTP resync bounds (15 min - 24 h)
+#define CLOCK_SYNC_MAX_INTERVAL 86400000
+#define CLOCK_DRIFT_MIN_SPAN_MS 600000  // Shortest span between syncs used to measure drift
+
 #define STOP_NAME "Statenkwartier"
-#define UPDATE_INTERVAL 20000
+#define BOARD_TITLE "Tram 17"  // Header of the quadrant board
+
+// Stops merged into one board: { stop code, line filter, destination filter }.
+// Add the other platform's stop code here to show both directions.
+#define STOP_LIST { \
+    { "NL:S:32000903", nullptr, nullptr }, \
+}
+
+// Departure polling bounds (ms); the interval adapts to the next tram in between
+#define POLL_MIN_INTERVAL   30000    // Tram about to arrive or data changing a lot
+#define POLL_MAX_INTERVAL   300000   // Next tram far away
+#define POLL_NIGHT_INTERVAL 1800000  // No departures during the night window
+#define POLL_NIGHT_START_HOUR 1      // Night window [start, end) in local hours
+#define POLL_NIGHT_END_HOUR   5
+
+#define DISPLAY_BANDED 1        // Compose the board in RAM bands; 0 draws straight to the panel
+#define DISPLAY_BAND_LINES 16   // Height of a full-width band (160 x 16 x 2 = 5 KB)
+#define BOARD_LAYOUT_LIST 0      // 1 = scrolling list of every departure instead of the quadrant board
+#define TRAM_CARD_WIDTH 80       // One departure per card in the scrolling list
+#define TRAM_SCROLL_FRAME_MS 40  // One pixel of hardware scroll per frame (25 fps)
+#define ESPNOW_QUEUE_SIZE 8      // Sensor packets buffered between radio callback and main loop (power of 2)
+#define SENSOR_TABLE_SIZE 64     // Sensor table slots (power of 2), holds up to 48 sensors
+#define SENSOR_NAME_LEN 12       // Sensor names, including the terminator
+#define SENSOR_RESYNC_GAP 64     // A sequence this far behind is a restart, not a late frame
+#define SENSOR_RESYNC_SILENCE_MS 600000  // Late or retried frames arrive within seconds; after this the sequence starts afresh
+#define BOARD_SENSOR_CELLS 3     // Sensor cells across the bottom of the board
+#define BOARD_TREND_POINTS 24    // Hourly moisture points in each cell's sparkline
+#define SENSOR_PAGE_MS 5000      // Time each page of sensor cells is shown
+
+// Names for sensors known in advance; others register on their first
+// packet and are named after their MAC until renamed
+#define SENSOR_NAMES { \
+    { 0x80F1B2502974ull, "Olga" }, \
+    { 0x80F1B2502948ull, "A&E" }, \
+}
+
+// ESP-NOW load test (see espnow_loadgen.h)
+#ifndef ESPNOW_LOADGEN           // The native tests build with it set
+#define ESPNOW_LOADGEN 0         // 1 = feed synthetic sensor frames into the receiver at boot
+#endif
+#define LOADGEN_MAC_PREFIX 0x024C47  // First three bytes of every made-up sender's MAC
+#define LOADGEN_SENDERS 24       // Made-up sensors taking turns
+#define LOADGEN_READINGS 4       // Readings per frame
+#define LOADGEN_RATES { 10, 50, 200, 1000, 3000 }  // Frames per second, one step each
+#define LOADGEN_SECONDS 10       // Duration of each step
+#define LOADGEN_START_DELAY 5000 // Wait after boot before the first step
+
+// Sensor history: recent readings plus hourly and daily buckets
+#define HISTORY_SENSORS 4        // Sensors with trend history in memory at once
+#define HISTORY_RAW_BYTES 128    // Delta-encoded recent readings per sensor (3-5 bytes each)
+#define HISTORY_HOURS 24         // Hourly buckets per sensor
+#define HISTORY_DAYS 28          // Daily buckets per sensor
+#define HISTORY_FLASH 1          // Mirror the history to flash
+#define HISTORY_FLUSH_INTERVAL 21600000  // At most one history write per 6 hours
+
+#define SNAPSHOT_MIN_INTERVAL 900000  // Shortest gap between snapshot writes to flash
+#define RENDER_INTERVAL 1000    // Countdown recomputed from absolute departure times
+
+#define HTTP_TIMEOUT_MS 10000   // Connect/read timeout for HTTP requests
+#define FETCH_CHUNK_SIZE 512    // Bytes read from the HTTP stream at a time
+#define HTTP_DRAIN_LIMIT 65536  // Max unread body skipped to keep a socket alive
 
 // Weather API (Open-Meteo - no API key needed!)
 #define WEATHER_LAT "52.0767"
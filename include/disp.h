@@ -2,19 +2,35 @@
 #define DISP_H
 #include <Adafruit_ST7735.h>
 #include <Adafruit_GFX.h>
-#include <vector>
 #include "api.h"
 #include "espnow_receiver.h"
+#include "sensor_history.h"
 #include "weather.h"
 
 extern Adafruit_ST7735* tft;
 
 void initDisplay();
-void showMessage(String msg);
-void showDebugInfo(String msg, int httpCode, int htmlSize, int found);
-void showTrams(std::vector<Tram> trams);
-void showTramsWithSensor(std::vector<Tram> trams, const sensor_data_t& sensorData);
-void showTramsWithWeatherAndSensor(std::vector<Tram> trams, const Weather& weather, const sensor_data_t& olgaData, const sensor_data_t& aeData, bool hasOlga, bool hasAE);
+void showMessage(const char* msg);
+void showDebugInfo(const char* msg, int httpCode, int htmlSize, int found);
+// Scrolling list of every departure; returns false when nothing changed
+bool showTrams(const DepartureTable& trams);
+// Advance the list's hardware scroll; call at least every TRAM_SCROLL_FRAME_MS
+void tickTramScroll();
+void showTramsWithSensor(const DepartureTable& trams, const sensor_data_t& sensorData);
+// One cell of the board's sensor panel
+struct SensorCell {
+    const char* name;    // nullptr = empty cell
+    sensor_data_t data;
+    bool fresh;          // false: no recent reading, values show "--"
+    uint8_t trend[BOARD_TREND_POINTS];  // Moisture per hour, oldest first; HISTORY_NO_DATA = none
+    uint8_t trendPoints;                // 0 = no sparkline
+};
+
+// cells holds BOARD_SENSOR_CELLS entries, the sensors on page `page` of `pages`.
+// Returns false when nothing visible changed and the redraw was skipped
+bool showTramsWithWeatherAndSensor(const DepartureTable& trams, const Weather& weather, const SensorCell* cells, uint8_t page, uint8_t pages);
+// Mark the board as restored data; asOf stands in for the clock until NTP sets it
+void setBoardStale(bool stale, time_t asOf);
 void setDisplayBrightness(int percent);
 void updateBrightnessForTime();
 
@@ -0,0 +1,44 @@
+#ifndef DISPLAY_METER_H
+#define DISPLAY_METER_H
+#include <Adafruit_ST7735.h>
+
+// ST7735 driver that counts what each draw call costs on the SPI bus.
+// Every Adafruit_SPITFT primitive opens an address window before pushing
+// pixels, so windows, pixels and bytes are all counted in setAddrWindow.
+// Bare commands such as the hardware scroll ones go through sendCommand,
+// which is not virtual: call it on the MeteredST7735 to have it counted.
+
+struct DisplayCost {
+    uint32_t transactions;  // SPI transactions (startWrite)
+    uint32_t windows;       // Address windows set
+    uint32_t pixels;        // Pixels the windows cover
+    uint32_t commands;      // Bare commands (sendCommand)
+    uint32_t bytes;         // Commands, window arguments and pixel data
+    uint32_t us;            // Wall time of the call
+};
+
+class MeteredST7735 : public Adafruit_ST7735 {
+public:
+    MeteredST7735(int8_t cs, int8_t dc, int8_t rst) : Adafruit_ST7735(cs, dc, rst) {}
+
+    void startWrite() override;
+    void setAddrWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h) override;
+    void sendCommand(uint8_t cmd, const uint8_t* data = nullptr, uint8_t len = 0);
+
+    // Start counting a draw call. Calls nest; only the outermost one counts.
+    void beginCost();
+    // Finish it and log the totals under name if anything was sent.
+    // With no name the totals are only kept in lastCost().
+    void endCost(const char* name);
+
+    const DisplayCost& lastCost() const { return last; }
+    static void logCost(const char* name, const DisplayCost& c);
+
+private:
+    DisplayCost cost = {};
+    DisplayCost last = {};
+    unsigned long startUs = 0;
+    uint8_t depth = 0;
+};
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef DRGL_PARSER_H
+#define DRGL_PARSER_H
+#include <stddef.h>
+#include <stdint.h>
+
+// Incremental parser for the DRGL stop page.
+// Bytes are fed in arbitrary chunks; the HH:MM / line / destination state
+// survives chunk boundaries, so the page never has to be held in memory.
+
+#define DRGL_MAX_LINE 4
+#define DRGL_MAX_DEST 50
+
+struct DrglRecord {
+    char time[6];                   // "HH:MM"
+    char line[DRGL_MAX_LINE + 1];   // Line number digits, may be empty
+    char dest[DRGL_MAX_DEST + 1];   // Trimmed destination, may be empty
+};
+
+// Called for every departure found. Return false to stop parsing.
+typedef bool (*DrglRecordCallback)(const DrglRecord& rec, void* ctx);
+
+enum DrglState : uint8_t {
+    DRGL_SCAN_TIME,     // Looking for HH:MM
+    DRGL_SKIP_TO_LINE,  // Whitespace and tags between time and line
+    DRGL_LINE,          // Line number digits
+    DRGL_SKIP_TO_DEST,  // Whitespace and tags between line and destination
+    DRGL_DEST,          // Destination text
+    DRGL_DONE           // Callback asked to stop
+};
+
+struct DrglParser {
+    DrglState state;
+    bool inTag;
+    char window[5];     // Last bytes seen while scanning for HH:MM
+    uint8_t windowLen;
+    uint8_t lineLen;
+    uint8_t destLen;
+    DrglRecord rec;
+    DrglRecordCallback onRecord;
+    void* ctx;
+    const char* lineFilter;  // Exact line number to keep, nullptr = any
+    const char* destFilter;  // Substring the destination must contain, nullptr = any
+    bool skipRecord;         // Current row already failed the line filter
+    bool malformed;          // Current row is dropped as unparseable, not filtered
+    uint16_t filtered;       // Rows dropped by the filters
+    uint16_t rejected;       // Rows dropped for a line number longer than DRGL_MAX_LINE
+};
+
+void drglParserInit(DrglParser& p, DrglRecordCallback onRecord, void* ctx);
+
+// Only hand out rows for this line and/or destination; rows that fail are
+// skipped inside the parser and never reach the callback
+void drglParserSetFilter(DrglParser& p, const char* line, const char* dest);
+
+// Feed the next chunk of the page. Returns false once the callback has
+// asked to stop; further input is ignored.
+bool drglParserFeed(DrglParser& p, const char* data, size_t len);
+
+// Flush a departure that was still being read when the page ended.
+void drglParserFinish(DrglParser& p);
+
+#endif
@@ -0,0 +1,14 @@
+#ifndef ESPNOW_LOADGEN_H
+#define ESPNOW_LOADGEN_H
+
+// Synthetic sensor load for the ESP-NOW receive path, built with
+// ESPNOW_LOADGEN=1. A task plays LOADGEN_SENDERS made-up sensors into the
+// radio callback at each rate in LOADGEN_RATES while the main loop keeps
+// running, and logs throughput, drops, callback latency and heap use per
+// rate. The first rate that drops frames is the receiver's capacity.
+// Real sensor frames are not received during the run.
+
+// Start the run; does nothing unless ESPNOW_LOADGEN is set
+void startEspNowLoadGen();
+
+#endif
@@ -2,7 +2,7 @@
 #define ESPNOW_RECEIVER_H
 
 #include <Arduino.h>
-#include <map>
+#include "config.h"
 
 // Data structure matching the soil moisture sensor
 typedef struct sensor_data_t {
@@ -12,21 +12,67 @@ typedef struct sensor_data_t {
   unsigned long timestamp;
 } sensor_data_t;
 
-// Known sensor MAC addresses
-const uint64_t OLGA_MAC = 0x80F1B2502974;   // Olga sensor
-const uint64_t AE_MAC   = 0x80F1B2502948;   // A&E sensor
+// Everything known about one sensor, kept together in a single table slot
+struct SensorState {
+  uint64_t mac;             // 0 = unused slot
+  char name[SENSOR_NAME_LEN];  // From the registry, SENSOR_NAMES, or the MAC
+  sensor_data_t data;       // Latest reading
+  unsigned long lastSeen;   // millis() when it arrived
+  uint32_t packets;         // Frames accepted
+  uint16_t lastSequence;    // Newest frame applied, sensor_wire.h format only
+  bool hasSequence;
+};
 
-// Helper to convert MAC array to uint64_t for map key
+// Helper to convert MAC array to uint64_t for table key
 uint64_t macToUint64(const uint8_t* mac);
 
+// Packets handed from the radio callback to the main loop
+struct EspNowStats {
+  uint32_t received;       // Queued for the main loop
+  uint32_t dropped;        // Lost because the queue was full
+  uint32_t rejected;       // Not a sensor_wire.h frame nor a raw sensor_data_t
+  uint32_t maxQueueDepth;  // Most packets ever waiting at once
+  uint32_t sensors;        // Distinct sensors in the table
+  uint32_t sensorsRefused; // Packets from new sensors that did not fit
+  uint32_t duplicates;     // Frames with the sequence number just applied
+  uint32_t reordered;      // Frames older than one already applied
+  uint32_t resynced;       // Old sequence numbers taken as a sensor restart
+  uint32_t processed;      // Frames taken off the queue by the main loop
+  uint32_t processUs;      // Main loop time spent applying them, excluding logs
+  uint32_t callbackP50Us;  // Radio callback duration percentiles
+  uint32_t callbackP99Us;
+  uint32_t callbackMaxUs;
+};
+
 // Functions
 void initESPNowReceiver();
+// Apply packets queued by the radio callback; call from the main loop
+void processSensorPackets();
+EspNowStats getEspNowStats();
+// Start new callback latency and queue depth measurements
+void resetEspNowPeaks();
+// Drop the load generator's made-up senders from the table. Safe from any
+// task; done by the next processSensorPackets() after the queue drains.
+void evictSyntheticSensors();
+// Radio receive callback; the load generator feeds it directly while the
+// radio is detached, so the queue never has two producers
+void onDataRecv(const uint8_t *mac_addr, const uint8_t *data, int data_len);
+void detachEspNowRadio();
+void attachEspNowRadio();
+// One lookup for reading, age and stats; nullptr if never heard from
+const SensorState* findSensor(uint64_t macAddress);
+// Registered sensors in the order they first appeared, including known
+// sensors that have not reported since boot (packets == 0)
+uint32_t sensorCountRegistered();
+const SensorState* sensorAt(uint32_t index);
+// Rename a sensor, registering it if needed; kept in flash
+bool setSensorName(uint64_t macAddress, const char* name);
 bool hasSensorData(uint64_t macAddress);
 sensor_data_t getSensorData(uint64_t macAddress);
 unsigned long getLastReceivedTime(uint64_t macAddress);
 void printSensorData(const sensor_data_t& data, const uint8_t* mac);
 
-// Legacy functions for backward compatibility (use Olga data)
+// Legacy functions for backward compatibility (use the first registered sensor)
 bool hasSensorData();
 sensor_data_t getLatestSensorData();
 unsigned long getLastReceivedTime();
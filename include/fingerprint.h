@@ -0,0 +1,28 @@
+#ifndef FINGERPRINT_H
+#define FINGERPRINT_H
+#include <stddef.h>
+#include <stdint.h>
+
+// FNV-1a, used to notice when fetched or displayed data did not change
+
+#define FINGERPRINT_SEED 2166136261u
+
+inline uint32_t fingerprint(const void* data, size_t len, uint32_t h = FINGERPRINT_SEED) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < len; i++) {
+        h ^= p[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// Includes the terminator so adjacent fields cannot run into each other
+inline uint32_t fingerprintStr(const char* s, uint32_t h = FINGERPRINT_SEED) {
+    do {
+        h ^= (uint8_t)*s;
+        h *= 16777619u;
+    } while (*s++);
+    return h;
+}
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef HTTP_CONN_H
+#define HTTP_CONN_H
+#include <Arduino.h>
+#include <HTTPClient.h>
+#include <WiFiClientSecure.h>
+
+// Shared HTTPS connections, one kept-alive TLS socket per upstream host.
+// A request on a live socket costs one round trip instead of a handshake.
+
+enum HttpHost : uint8_t {
+    HOST_DRGL,
+    HOST_WEATHER,
+    HOST_COUNT
+};
+
+struct HttpConnStats {
+    uint32_t requests;       // GETs sent
+    uint32_t handshakes;     // New TLS connections opened
+    uint32_t reused;         // GETs sent on a kept-alive socket
+    uint32_t lastConnectMs;  // Duration of the most recent handshake
+    uint32_t lastRequestMs;  // Request to response headers, excluding any handshake
+};
+
+// Response body reader; handles both Content-Length and chunked framing
+struct HttpBody {
+    HttpHost host;
+    WiFiClient* stream;
+    bool chunked;
+    bool done;
+    bool failed;
+    int32_t remaining;  // Bytes left in the body (identity) or current chunk, -1 = until close
+};
+
+// Cache validators from the last 200 response, sent back as
+// If-None-Match / If-Modified-Since so the server can answer 304
+struct HttpValidators {
+    char etag[72];
+    char lastModified[40];
+};
+
+// Send a GET on the host's connection, opening it if needed. Returns the
+// HTTP status code (negative on transport errors); on 200 body is ready.
+// With validators the request is conditional and they are updated on 200.
+int httpGet(HttpHost host, const char* url, HttpBody& body, HttpValidators* validators = nullptr);
+
+// Read up to len body bytes. Returns 0 at the end of the body, -1 on error.
+int httpRead(HttpBody& body, char* buf, size_t len);
+
+// Finish the request. With keepAlive the rest of the body is drained so
+// the socket can carry the next request; otherwise the socket is closed.
+void httpFinish(HttpBody& body, bool keepAlive);
+
+const HttpConnStats& getHttpConnStats(HttpHost host);
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef NET_TASK_H
+#define NET_TASK_H
+#include <Arduino.h>
+#include "api.h"
+#include "weather.h"
+
+// Network fetches run in their own FreeRTOS task so the main loop keeps
+// rendering while HTTP is in progress. Jobs go in, results come back
+// through queues; nothing here blocks the caller.
+
+enum NetJob : uint8_t {
+    NET_JOB_TRAMS   = 1 << 0,
+    NET_JOB_WEATHER = 1 << 1
+};
+
+struct NetResult {
+    uint8_t jobs;            // Which of the fields below are filled in
+    FetchResult tramResult;
+    DepartureTable trams;
+    bool weatherOk;
+    Weather weather;
+    uint32_t durationMs;     // Time the task spent on the jobs
+};
+
+void startNetTask();
+
+// Queue a combination of NetJob bits; false when the queue is full
+bool requestNetJobs(uint8_t jobs);
+
+// Take the next finished result, if any
+bool pollNetResult(NetResult& result);
+
+#endif
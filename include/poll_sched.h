@@ -0,0 +1,28 @@
+#ifndef POLL_SCHED_H
+#define POLL_SCHED_H
+#include <Arduino.h>
+#include <time.h>
+#include "api.h"
+
+// Adaptive polling for departures: fetch often when a tram is close or the
+// data keeps changing, rarely when the next tram is far away or at night.
+
+struct PollStats {
+    uint32_t fetches;
+    uint32_t changed;         // Fetches that actually changed the table
+    uint32_t lastIntervalMs;  // Most recently chosen interval
+    uint32_t minIntervalMs;   // Shortest interval chosen so far
+    uint32_t maxIntervalMs;   // Longest interval chosen so far
+    float volatility;         // Moving average of "fetch changed the data", 0..1
+};
+
+// Feed the outcome of a fetch into the volatility estimate
+void pollRecordFetch(FetchResult result);
+
+// Milliseconds until the next fetch, bounded by POLL_MIN/MAX_INTERVAL
+// (POLL_NIGHT_INTERVAL when there is no service)
+uint32_t pollNextInterval(const DepartureTable& trams, time_t now);
+
+const PollStats& getPollStats();
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef SENSOR_HISTORY_H
+#define SENSOR_HISTORY_H
+#include <Arduino.h>
+#include <time.h>
+#include "espnow_receiver.h"
+
+// Moisture and battery history per sensor, in three tiers:
+//  - the latest readings, delta + varint encoded (2-4 bytes each)
+//  - hourly min/max/avg buckets for the last HISTORY_HOURS hours
+//  - daily min/max/avg buckets for the last HISTORY_DAYS days
+// A sparkline uses the exact readings while they reach back over its window
+// and the buckets beyond that. Both are fixed size, so it does bounded work
+// no matter how much history there is. With more sensors than
+// HISTORY_SENSORS, the one heard from longest ago gives up its slot.
+
+#define HISTORY_NO_DATA 0xFF  // Sparkline point with no readings
+
+enum HistoryMetric : uint8_t {
+    HISTORY_MOISTURE,
+    HISTORY_BATTERY
+};
+
+struct HistoryReading {
+    uint32_t time;  // Epoch seconds
+    uint8_t moisture;
+    uint8_t battery;
+};
+
+// Add a reading received at now (epoch seconds). Ignored until the clock is set.
+void recordSensorHistory(uint64_t mac, const sensor_data_t& data, time_t now);
+
+// Average of metric per point over the last `seconds`, oldest point first.
+// Returns the number of points written (0 if the sensor has no history).
+int sensorSparkline(uint64_t mac, HistoryMetric metric, uint32_t seconds, time_t now,
+                    uint8_t* out, int points);
+
+// Write changed histories to flash if the last write is HISTORY_FLUSH_INTERVAL ago
+void flushSensorHistory();
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef SENSOR_WIRE_H
+#define SENSOR_WIRE_H
+#include <stddef.h>
+#include <stdint.h>
+
+// ESP-NOW frame sent by the plant sensors. Every field is little-endian
+// and byte-packed, so the layout does not depend on either compiler.
+//
+//   Header, 6 bytes
+//     0  u8   magic 'P' (0x50)
+//     1  u8   version, SENSOR_WIRE_VERSION
+//     2  u16  sequence number, +1 per frame, wraps
+//     4  u8   readings in this frame, 1..SENSOR_WIRE_MAX_READINGS
+//     5  u8   flags, SENSOR_WIRE_FLAG_*
+//   Reading, 8 bytes each, oldest first
+//     0  u16  battery voltage in mV
+//     2  u8   battery percent
+//     3  u8   reserved, 0
+//     4  u16  soil moisture in 0.1 %
+//     6  u16  seconds between taking the reading and sending the frame
+//
+// 6 + 8n bytes never equals sizeof(sensor_data_t) (16), so frames from
+// sensors still sending the raw struct are told apart by length.
+
+#define SENSOR_WIRE_MAGIC 0x50
+#define SENSOR_WIRE_VERSION 1
+#define SENSOR_WIRE_HEADER_SIZE 6
+#define SENSOR_WIRE_READING_SIZE 8
+#define SENSOR_WIRE_MAX_READINGS 16
+#define SENSOR_WIRE_MAX_FRAME (SENSOR_WIRE_HEADER_SIZE + SENSOR_WIRE_MAX_READINGS * SENSOR_WIRE_READING_SIZE)
+
+#define SENSOR_WIRE_FLAG_BOOT 0x01  // First frame since power-on, sequence restarted
+
+struct SensorWireHeader {
+    uint8_t version;
+    uint16_t sequence;
+    uint8_t count;
+    uint8_t flags;
+};
+
+struct SensorWireReading {
+    uint16_t batteryMv;
+    uint8_t batteryPercent;
+    uint16_t moisturePermille;
+    uint16_t ageSeconds;
+};
+
+// Check magic, version and that len matches the reading count
+bool sensorWireParseHeader(const uint8_t* frame, size_t len, SensorWireHeader& header);
+
+// Reading i of a frame that passed sensorWireParseHeader
+SensorWireReading sensorWireReading(const uint8_t* frame, uint8_t i);
+
+// Build a frame; returns its length, 0 if count or the buffer is too small
+size_t sensorWireEncode(uint8_t* frame, size_t size, uint16_t sequence, uint8_t flags,
+                        const SensorWireReading* readings, uint8_t count);
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+#include <Arduino.h>
+#include <time.h>
+#include "api.h"
+#include "weather.h"
+
+// Last good departures and weather kept in NVS, so a reset can put the
+// board back on screen before WiFi and NTP are up. Writes are skipped when
+// nothing changed and rate limited to SNAPSHOT_MIN_INTERVAL to spare flash.
+
+// Restore the snapshot into table and weather; savedAt is when it was
+// taken. Returns false when there is none or it does not match this build.
+bool loadSnapshot(DepartureTable& table, Weather& weather, time_t& savedAt);
+
+// Store the current board if it differs from the stored one and the last
+// write is long enough ago. Returns true when flash was written.
+bool saveSnapshot(const DepartureTable& table, const Weather& weather);
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+// Fixed-size lock-free queue for exactly one producer and one consumer,
+// e.g. a radio callback handing packets to the main loop. No allocation,
+// no locks; push() and pop() are safe to call concurrently from the two
+// sides. N must be a power of two.
+
+template <typename T, size_t N>
+class SpscRing {
+    static_assert((N & (N - 1)) == 0, "SpscRing size must be a power of two");
+
+public:
+    // Producer side. Returns false when the ring is full.
+    bool push(const T& item) {
+        uint32_t head = head_.load(std::memory_order_relaxed);
+        uint32_t tail = tail_.load(std::memory_order_acquire);
+        if (head - tail >= N) return false;
+        items_[head & (N - 1)] = item;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Returns false when the ring is empty.
+    bool pop(T& item) {
+        uint32_t tail = tail_.load(std::memory_order_relaxed);
+        uint32_t head = head_.load(std::memory_order_acquire);
+        if (head == tail) return false;
+        item = items_[tail & (N - 1)];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Entries waiting; exact on the producer side, a lower bound elsewhere
+    uint32_t depth() const {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+
+private:
+    T items_[N];
+    std::atomic<uint32_t> head_{0};  // Next slot to write, only the producer stores
+    std::atomic<uint32_t> tail_{0};  // Next slot to read, only the consumer stores
+};
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef STR_POOL_H
+#define STR_POOL_H
+#include <stdint.h>
+
+// Small intern pool for line and destination names.
+// The same handful of names comes back every fetch, so after warm-up
+// interning is a hash lookup and never touches the heap. Names that no
+// table refers to any more are reclaimed by a mark-and-sweep.
+
+#define STR_POOL_BYTES   512  // Character storage, including terminators
+#define STR_POOL_ENTRIES 32   // Distinct strings
+#define STR_NONE         0xFF // Returned when the pool is full
+
+uint8_t internString(const char* s);
+const char* pooledString(uint8_t id);
+
+// True once an intern failed, or the pool is three quarters full
+bool strPoolWantsSweep();
+
+// Reclaim strings: begin, mark every id still referenced, then sweep.
+// Marked ids keep their value; unmarked ones are freed and reused later.
+// Must not run while another task interns or reads pooled strings.
+void strPoolBeginSweep();
+void strPoolMark(uint8_t id);
+void strPoolSweep();
+
+#endif
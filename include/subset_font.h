@@ -0,0 +1,42 @@
+#ifndef SUBSET_FONT_H
+#define SUBSET_FONT_H
+#include <Adafruit_GFX.h>
+
+// Fonts cut down at build time to the characters the board draws (see
+// scripts/font_subset.py). Glyphs are run-length encoded in row-major
+// order, so decoding yields whole horizontal runs instead of single
+// pixels. Positioning matches Adafruit GFX custom fonts: y is the baseline.
+// The tables are plain const data: the ESP32 maps flash into the address
+// space, so they stay in flash and are read directly, without PROGMEM.
+// This is the first-use glyph run cache moved to build time: the runs it
+// built in RAM now come precomputed from flash.
+
+// Fields ordered widest first so the table has no padding; the size
+// math in the script assumes this layout
+struct SubsetGlyph {
+    uint16_t offset;   // Start of the glyph's runs in the font data
+    uint16_t length;   // Bytes of run data
+    char c;
+    uint8_t width;
+    uint8_t height;
+    uint8_t xAdvance;
+    int8_t xOffset;
+    int8_t yOffset;
+};
+
+struct SubsetFont {
+    const uint8_t* data;
+    const SubsetGlyph* glyphs;  // Sorted by character
+    uint8_t count;
+    uint8_t yAdvance;
+};
+
+// Draw text with its baseline at y. Characters outside the subset are
+// skipped and logged once each.
+void drawSubsetText(Adafruit_GFX& g, const SubsetFont* font, int16_t x, int16_t y, uint16_t color, const char* text);
+
+// Same contract as Adafruit_GFX::getTextBounds
+void subsetTextBounds(const SubsetFont* font, const char* text, int16_t x, int16_t y,
+                      int16_t* x1, int16_t* y1, uint16_t* w, uint16_t* h);
+
+#endif
@@ -0,0 +1,18 @@
+#ifndef SWAR_SCAN_H
+#define SWAR_SCAN_H
+#include <stddef.h>
+
+// Word-at-a-time (SWAR) byte scanners over raw character spans.
+// Plain C++ with no Arduino dependencies, so they also build on the host.
+// Each function returns the index of the first match, or n when none.
+
+// First occurrence of byte c
+size_t swarFindByte(const char* p, size_t n, char c);
+
+// First occurrence of any of the bytes a, b, c
+size_t swarFindAny3(const char* p, size_t n, char a, char b, char c);
+
+// Start of the first "dd:dd" pattern lying entirely inside the span
+size_t swarFindTime(const char* p, size_t n);
+
+#endif
@@ -8,7 +8,7 @@ struct Weather {
   float tempMin;
   float tempMax;
   float windSpeed;  // in m/s
-  String description;
+  const char* description;
   bool valid;
 };
 
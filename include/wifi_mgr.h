@@ -2,6 +2,32 @@
 #define WIFI_MGR_H
 #include <WiFi.h>
 
-bool connectWiFi();
+struct WifiConnectStats {
+    uint32_t lastConnectMs;  // begin() to connected, for the last successful connect
+    bool lastFast;           // Last connect skipped the scan (and DHCP while the lease was fresh)
+    uint32_t fastConnects;
+    uint32_t scanConnects;
+    uint32_t fastFailures;   // Fast attempts that fell back to a scan
+};
+
+// Connection and time sync run as a state machine driven by WiFi and SNTP
+// events; nothing here blocks. Lost links are retried with backoff.
+enum LinkState : uint8_t {
+    LINK_IDLE,     // startWiFi() not called yet
+    LINK_FAST,     // Joining the saved BSSID and channel
+    LINK_SCAN,     // Joining after a full scan
+    LINK_UP,       // Connected with an address
+    LINK_BACKOFF   // Waiting before the next attempt
+};
+
+// Set up the radio, register the handlers (once) and start connecting
+void startWiFi();
+// Act on events and timeouts; call from loop()
+void tickWiFi();
+bool wifiConnected();
+// True once SNTP has set the clock since boot
+bool timeIsSynced();
+LinkState getLinkState();
+const WifiConnectStats& getWiFiConnectStats();
 
 #endif
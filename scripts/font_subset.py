@@ -0,0 +1,212 @@
+"""Emit subset fonts for the board as subset_fonts.h.
+
+Runs before every PlatformIO build (extra_scripts = pre:...). It reads the
+Adafruit GFX font headers, keeps only the characters the layouts in
+src/disp.cpp can produce, and re-encodes each glyph as run lengths in the
+order a windowed write streams pixels. The header is a build product: it is
+written to $BUILD_DIR/generated, which is added to the include path.
+
+After linking, the flash the subset fonts actually take is read from the
+firmware's symbol table and printed next to the size of the full fonts.
+
+Standalone: python scripts/font_subset.py <Adafruit GFX Fonts dir> [output]
+
+Glyph encoding: bytes of alternating background / foreground run lengths
+over the glyph box, row-major, starting with background. A run longer
+than 255 is split with a zero-length run of the other kind. Trailing
+background is dropped.
+"""
+
+import glob
+import os
+import re
+import subprocess
+import sys
+
+# Font -> characters the board can draw with it
+SUBSETS = {
+    "FreeSansBold18pt7b": "0123456789NOW-",  # First departure
+    "FreeSansBold12pt7b": "0123456789-",     # Current temperature
+}
+
+HEADER = "subset_fonts.h"
+
+# C layouts on the 32-bit target, as (size, alignment) per member
+POINTER = (4, 4)
+U8 = (1, 1)
+U16 = (2, 2)
+GFX_GLYPH = [U16, U8, U8, U8, U8, U8]             # bitmapOffset, width, height, xAdvance, xOffset, yOffset
+GFX_FONT = [POINTER, POINTER, U16, U16, U8]        # bitmap, glyph, first, last, yAdvance
+SUBSET_GLYPH = [U16, U16, U8, U8, U8, U8, U8, U8]  # Must match SubsetGlyph in subset_font.h
+SUBSET_FONT = [POINTER, POINTER, U8, U8]           # Must match SubsetFont
+
+
+def c_sizeof(members):
+    """sizeof() of a struct with these members, padding included"""
+    offset = 0
+    align = 1
+    for size, a in members:
+        offset = (offset + a - 1) // a * a + size
+        align = max(align, a)
+    return (offset + align - 1) // align * align
+
+
+def parse_font(path, name):
+    with open(path) as f:
+        src = f.read()
+
+    bitmap = re.search(r"%sBitmaps\[\]\s*PROGMEM\s*=\s*\{(.*?)\};" % name, src, re.S)
+    glyphs = re.search(r"%sGlyphs\[\]\s*PROGMEM\s*=\s*\{(.*?)\};" % name, src, re.S)
+    font = re.search(r"GFXfont\s+%s\s+PROGMEM\s*=\s*\{(.*?)\};" % name, src, re.S)
+    if not (bitmap and glyphs and font):
+        raise ValueError("%s: not an Adafruit GFX font header" % path)
+
+    data = [int(v, 16) for v in re.findall(r"0x[0-9A-Fa-f]+", bitmap.group(1))]
+    table = [tuple(int(v) for v in g)
+             for g in re.findall(r"\{\s*(-?\d+),\s*(-?\d+),\s*(-?\d+),\s*(-?\d+),\s*(-?\d+),\s*(-?\d+)\s*\}",
+                                 glyphs.group(1))]
+    fields = [v.strip() for v in font.group(1).split(",")]
+    first, last, y_advance = int(fields[-3], 0), int(fields[-2], 0), int(fields[-1], 0)
+    return data, table, first, last, y_advance
+
+
+def encode_glyph(data, offset, width, height):
+    runs = []
+    current = False  # Runs start with background
+    length = 0
+    bit = offset * 8
+    for _ in range(width * height):
+        on = bool(data[bit >> 3] & (0x80 >> (bit & 7)))
+        bit += 1
+        if on != current:
+            runs.append(length)
+            current = on
+            length = 0
+        length += 1
+    if current:
+        runs.append(length)  # Trailing background is implied
+
+    out = []
+    for r in runs:
+        while r > 255:
+            out += [255, 0]
+            r -= 255
+        out.append(r)
+    return out
+
+
+def subset_font(fonts_dir, name, chars):
+    data, table, first, last, y_advance = parse_font(os.path.join(fonts_dir, name + ".h"), name)
+
+    stream = []
+    glyphs = []
+    for c in sorted(set(chars)):
+        code = ord(c)
+        if code < first or code > last:
+            raise ValueError("%s has no glyph for %r" % (name, c))
+        offset, width, height, x_advance, x_offset, y_offset = table[code - first]
+        rle = encode_glyph(data, offset, width, height)
+        glyphs.append((len(stream), len(rle), c, width, height, x_advance, x_offset, y_offset))
+        stream += rle
+
+    original = len(data) + c_sizeof(GFX_GLYPH) * len(table) + c_sizeof(GFX_FONT)
+    subset = len(stream) + c_sizeof(SUBSET_GLYPH) * len(glyphs) + c_sizeof(SUBSET_FONT)
+    return stream, glyphs, y_advance, original, subset
+
+
+def c_char(c):
+    return "'\\''" if c == "'" else "'\\\\'" if c == "\\" else "'%s'" % c
+
+
+def generate(fonts_dir, out_path):
+    lines = [
+        "// Generated by scripts/font_subset.py from the Adafruit GFX fonts. Do not edit.",
+        "#ifndef SUBSET_FONTS_H",
+        "#define SUBSET_FONTS_H",
+        '#include "subset_font.h"',
+        "",
+    ]
+    report = []
+    for name, chars in SUBSETS.items():
+        stream, glyphs, y_advance, original, subset = subset_font(fonts_dir, name, chars)
+        report.append("%s: %d -> %d bytes (%d glyphs)" % (name, original, subset, len(glyphs)))
+
+        lines.append("// %s" % chars)
+        lines.append("static const uint8_t %sSubsetData[] = {" % name)
+        for i in range(0, len(stream), 16):
+            lines.append("    " + ", ".join("%d" % b for b in stream[i:i + 16]) + ",")
+        lines.append("};")
+        lines.append("static const SubsetGlyph %sSubsetGlyphs[] = {" % name)
+        for offset, length, c, w, h, xa, xo, yo in glyphs:
+            lines.append("    { %d, %d, %s, %d, %d, %d, %d, %d }," % (offset, length, c_char(c), w, h, xa, xo, yo))
+        lines.append("};")
+        lines.append("static const SubsetFont %sSubset = { %sSubsetData, %sSubsetGlyphs, %d, %d };"
+                     % (name, name, name, len(glyphs), y_advance))
+        lines.append("")
+    lines.append("#endif")
+
+    text = "\n".join(lines) + "\n"
+    # Leave the file alone when nothing changed, so it does not force a rebuild
+    if not os.path.exists(out_path) or open(out_path).read() != text:
+        os.makedirs(os.path.dirname(out_path) or ".", exist_ok=True)
+        with open(out_path, "w") as f:
+            f.write(text)
+    for r in report:
+        print("font_subset: " + r)
+
+
+def full_font_size(fonts_dir, name):
+    data, table, _, _, _ = parse_font(os.path.join(fonts_dir, name + ".h"), name)
+    return len(data) + c_sizeof(GFX_GLYPH) * len(table) + c_sizeof(GFX_FONT)
+
+
+def linked_sizes(nm, elf):
+    """Bytes of each font's Subset* symbols in the linked firmware"""
+    out = subprocess.run([nm, "--print-size", "--demangle", elf], check=True, capture_output=True, text=True).stdout
+    sizes = dict.fromkeys(SUBSETS, 0)
+    for line in out.splitlines():
+        parts = line.split()
+        if len(parts) != 4:
+            continue
+        for name in SUBSETS:
+            if parts[3].startswith(name + "Subset"):
+                sizes[name] += int(parts[1], 16)
+    return sizes
+
+
+def report_linked(fonts_dir, nm, elf):
+    for name, size in linked_sizes(nm, elf).items():
+        if size == 0:
+            print("font_subset: %s: not linked" % name)
+        else:
+            print("font_subset: %s: %d bytes linked (full font %d bytes)" % (name, size, full_font_size(fonts_dir, name)))
+
+
+def find_fonts_dir(libdeps):
+    for d in glob.glob(os.path.join(libdeps, "*", "Fonts")):
+        if os.path.exists(os.path.join(d, "FreeSansBold18pt7b.h")):
+            return d
+    return None
+
+
+if __name__ == "__main__":
+    if len(sys.argv) < 2:
+        sys.exit("usage: font_subset.py <fonts dir> [output]")
+    generate(sys.argv[1], sys.argv[2] if len(sys.argv) > 2 else HEADER)
+else:
+    Import("env")  # noqa: F821 - provided by PlatformIO
+    libdeps = os.path.join(env.subst("$PROJECT_LIBDEPS_DIR"), env.subst("$PIOENV"))  # noqa: F821
+    fonts = find_fonts_dir(libdeps)
+    if fonts is None:
+        # PlatformIO installs lib_deps before it runs pre scripts, so this
+        # means the install failed or Adafruit GFX is missing from lib_deps
+        sys.exit("font_subset: Adafruit GFX Fonts directory not found in %s.\n"
+                 "Check lib_deps in platformio.ini, then run: pio pkg install -e %s"
+                 % (libdeps, env.subst("$PIOENV")))  # noqa: F821
+    generated = os.path.join(env.subst("$BUILD_DIR"), "generated")  # noqa: F821
+    generate(fonts, os.path.join(generated, HEADER))
+    env.Append(CPPPATH=[generated])  # noqa: F821
+
+    nm = env.subst("$CC")[:-len("gcc")] + "nm"  # noqa: F821
+    env.AddPostAction("$BUILD_DIR/${PROGNAME}.elf",  # noqa: F821
+                      lambda target, source, env: report_linked(fonts, nm, str(target[0])))
@@ -1,6 +1,9 @@
 #include "api.h"
 #include "config.h"
-#include <HTTPClient.h>
+#include "drgl_parser.h"
+#include "str_pool.h"
+#include "http_conn.h"
+#include "fingerprint.h"
 #include <WiFi.h>
 #include <time.h>
 
@@ -14,208 +17,272 @@ int getLastHttpCode() { return lastHttpCode; }
 int getLastHtmlSize() { return lastHtmlSize; }
 int getLastFoundEntries() { return lastFoundEntries; }
 
-// Find the next occurrence of a substring, case-insensitive
-int findStrNoCase(const String& haystack, const char* needle, int startPos = 0) {
-    int needleLen = strlen(needle);
-    int haystackLen = haystack.length();
-    
-    for (int i = startPos; i <= haystackLen - needleLen; i++) {
-        bool match = true;
-        for (int j = 0; j < needleLen; j++) {
-            if (tolower(haystack[i + j]) != tolower(needle[j])) {
-                match = false;
-                break;
-            }
-        }
-        if (match) return i;
-    }
-    return -1;
-}
-
-// Extract text between two tags
-String extractBetween(const String& html, const char* startTag, const char* endTag, int& pos) {
-    int start = findStrNoCase(html, startTag, pos);
-    if (start == -1) return "";
+// Parse time string like "12:34" into an absolute departure time (0 if unknown)
+static time_t parseDepartureTime(const char* timeStr) {
+    if (strlen(timeStr) < 5) return 0;
     
-    start += strlen(startTag);
-    int end = findStrNoCase(html, endTag, start);
-    if (end == -1) return "";
-    
-    pos = end + strlen(endTag);
-    return html.substring(start, end);
-}
-
-// Parse time string like "12:34" and return minutes from now
-int parseTimeToMinutes(const String& timeStr) {
-    if (timeStr.length() < 5) return -1;
-    
-    int hour = timeStr.substring(0, 2).toInt();
-    int minute = timeStr.substring(3, 5).toInt();
+    int hour = (timeStr[0] - '0') * 10 + (timeStr[1] - '0');
+    int minute = (timeStr[3] - '0') * 10 + (timeStr[4] - '0');
     
     time_t now = time(nullptr);
-    if (now < 100000) return -1;
-    
-    struct tm* ti = localtime(&now);
-    int currentHour = ti->tm_hour;
-    int currentMinute = ti->tm_min;
+    if (now < 100000) return 0;
     
-    // Calculate minutes until departure
-    int departMinutes = hour * 60 + minute;
-    int currentMinutes = currentHour * 60 + currentMinute;
-    int diff = departMinutes - currentMinutes;
+    struct tm ti;
+    localtime_r(&now, &ti);
+    int diff = (hour * 60 + minute) - (ti.tm_hour * 60 + ti.tm_min);
     
     // Handle midnight crossing
-    if (diff < -720) diff += 1440;  // Next day
-    if (diff > 720) diff -= 1440;    // Previous day
+    if (diff < -720) ti.tm_mday += 1;  // Next day
+    if (diff > 720) ti.tm_mday -= 1;    // Previous day
     
-    return diff;
+    ti.tm_hour = hour;
+    ti.tm_min = minute;
+    ti.tm_sec = 0;
+    ti.tm_isdst = -1;  // Let mktime work out DST for that day
+    return mktime(&ti);
 }
 
-std::vector<Tram> fetchTrams() {
-    std::vector<Tram> trams;
-    lastHttpCode = 0;
-    lastHtmlSize = 0;
-    lastFoundEntries = 0;
-    
-    if (!WiFi.isConnected()) {
-        Serial.println("ERROR: WiFi not connected!");
-        return trams;
+// Stops on the board, with optional line/destination filters
+static const StopConfig stops[] = STOP_LIST;
+#define STOP_COUNT (sizeof(stops) / sizeof(stops[0]))
+
+// What each stop's previous fetch produced, so unchanged or failed stops
+// still contribute to the merged board
+struct StopState {
+    DepartureTable table;   // Every upcoming departure read, not just the window
+    HttpValidators validators;
+    uint32_t fingerprint;
+    bool haveFingerprint;
+    bool truncated;         // Page had more departures than the table holds
+};
+static StopState stopStates[STOP_COUNT];
+
+// Departures accepted from the page being read, before they go into the table
+static DrglRecord pending[MAX_TRAMS];
+
+// Make the next fetch of this stop unconditional and its parse unskippable
+static void forgetPage(StopState& stop) {
+    stop.haveFingerprint = false;
+    stop.validators.etag[0] = '\0';
+    stop.validators.lastModified[0] = '\0';
+}
+
+// Forget the cached page so the next fetch is unconditional. The table is
+// kept: its absolute times keep counting down until the network is back.
+static FetchResult fetchFailed(StopState& stop) {
+    pruneDeparted(stop.table, time(nullptr));
+    forgetPage(stop);
+    return FETCH_FAILED;
+}
+
+// Keep the table of a page that did not change. If the parse stopped at a
+// full table and departures have left since, the page holds rows that were
+// never read: ask for the whole page next time rather than run dry.
+static void keepTable(StopState& stop) {
+    pruneDeparted(stop.table, time(nullptr));
+    if (stop.truncated && stop.table.count < MAX_TRAMS) {
+        Serial.println("Stored departures ran short, next fetch is unconditional");
+        forgetPage(stop);
     }
+}
+
+struct CollectState {
+    uint8_t count;
+    int foundCount;
+    uint32_t fingerprint;
+};
+
+// Keep records that will be shown; stops the parser once the list is full
+static bool collectTram(const DrglRecord& rec, void* ctx) {
+    CollectState& state = *static_cast<CollectState*>(ctx);
+    state.foundCount++;
     
-    String url = "https://drgl.nl/stop/" + String(STOP_CODE);
-    Serial.printf("Fetching: %s\n", url.c_str());
+    time_t departs = parseDepartureTime(rec.time);
+    int mins = departs ? minutesUntil(departs, time(nullptr)) : -1;
     
-    HTTPClient http;
-    http.setTimeout(10000);  // 10 second timeout
-    http.setFollowRedirects(HTTPC_STRICT_FOLLOW_REDIRECTS);
+    Serial.printf("Found #%d: Time=%s Line=%s Dest=%s (%d min)\n", 
+                 state.foundCount, rec.time, rec.line, rec.dest, mins);
     
-    if (!http.begin(url)) {
-        Serial.println("ERROR: Failed to begin HTTP connection");
-        return trams;
+    // Keep every upcoming departure with a line number; the window is
+    // applied when the board is merged, so it can move without a new parse
+    if (mins >= 0 && rec.line[0] != '\0') {
+        pending[state.count++] = rec;
+        // Fingerprint only the departure-bearing fields, not the rest of the page
+        state.fingerprint = fingerprintStr(rec.time, state.fingerprint);
+        state.fingerprint = fingerprintStr(rec.line, state.fingerprint);
+        state.fingerprint = fingerprintStr(rec.dest, state.fingerprint);
     }
     
-    // Set user agent to avoid blocking
-    http.addHeader("User-Agent", "Mozilla/5.0 (ESP32)");
+    return state.count < MAX_TRAMS;
+}
+
+// Fetch one stop into its own table
+static FetchResult fetchStop(const StopConfig& config, StopState& stop) {
+    DepartureTable& table = stop.table;
+    
+    char url[96];
+    snprintf(url, sizeof(url), "https://drgl.nl/stop/%s", config.code);
+    Serial.printf("Fetching: %s\n", url);
     
     Serial.println("Sending HTTP GET request...");
-    lastHttpCode = http.GET();
+    HttpBody body;
+    lastHttpCode = httpGet(HOST_DRGL, url, body, &stop.validators);
     Serial.printf("HTTP Response Code: %d\n", lastHttpCode);
     
+    if (lastHttpCode == HTTP_CODE_NOT_MODIFIED) {
+        httpFinish(body, true);
+        keepTable(stop);
+        Serial.println("Page not modified, keeping departures");
+        return FETCH_NOT_MODIFIED;
+    }
+    
     if (lastHttpCode != 200) {
         Serial.printf("ERROR: HTTP failed with code %d\n", lastHttpCode);
-        http.end();
-        return trams;
+        if (lastHttpCode > 0) httpFinish(body, true);
+        return fetchFailed(stop);
     }
     
-    String html = http.getString();
-    lastHtmlSize = html.length();
-    http.end();
+    // Stream the page through the parser in fixed-size chunks, so peak memory
+    // does not depend on how large the page is.
+    // Looks for plain text like: "14:40 17 Wateringen" (HH:MM [line] [destination])
+    Serial.println("Parsing HTML for tram departures...");
     
-    Serial.printf("Received %d bytes of HTML\n", lastHtmlSize);
+    CollectState state = { 0, 0, FINGERPRINT_SEED };
+    DrglParser parser;
+    drglParserInit(parser, collectTram, &state);
+    drglParserSetFilter(parser, config.line, config.dest);
     
-    if (lastHtmlSize < 100) {
-        Serial.println("ERROR: HTML response too small");
-        return trams;
+    static char chunk[FETCH_CHUNK_SIZE];
+    bool parsing = true;
+    int n;
+    int pageSize = 0;
+    while (parsing && (n = httpRead(body, chunk, sizeof(chunk))) > 0) {
+        pageSize += n;
+        lastHtmlSize += n;
+        parsing = drglParserFeed(parser, chunk, n);
     }
     
-    // Simple text-based parsing for DRGL
-    // Look for simple text patterns like: "14:40 17 Wateringen"
-    // The page shows plain text in format: HH:MM [line] [destination]
+    if (parsing) {
+        if (body.failed) Serial.println("ERROR: Failed reading HTML");
+        drglParserFinish(parser);
+    } else {
+        Serial.printf("Got %d departures, skipping rest of page\n", MAX_TRAMS);
+    }
+    // Skipping the rest is far cheaper than a new TLS handshake next time
+    httpFinish(body, true);
     
-    Serial.println("Parsing HTML for tram departures...");
-    Serial.println("First 500 chars of HTML:");
-    Serial.println(html.substring(0, 500));
+    const HttpConnStats& conn = getHttpConnStats(HOST_DRGL);
+    Serial.printf("Received %d bytes of HTML, %d rows filtered out, %d malformed (request %lu ms, %lu handshakes / %lu requests)\n",
+                 pageSize, parser.filtered, parser.rejected, (unsigned long)conn.lastRequestMs,
+                 (unsigned long)conn.handshakes, (unsigned long)conn.requests);
     
-    int pos = 0;
-    int foundCount = 0;
+    if (body.failed && state.count == 0) {
+        return fetchFailed(stop);
+    }
     
-    // Look for time patterns HH:MM followed by a number (line) and text (destination)
-    while (pos < html.length() && trams.size() < 10) {
-        // Find time pattern HH:MM
-        bool foundTime = false;
-        String timeStr = "";
-        
-        for (int i = pos; i < html.length() - 4; i++) {
-            char c1 = html[i];
-            char c2 = html[i+1];
-            char c3 = html[i+2];
-            char c4 = html[i+3];
-            char c5 = html[i+4];
-            
-            // Check for HH:MM pattern (digit digit : digit digit)
-            if (isdigit(c1) && isdigit(c2) && c3 == ':' && isdigit(c4) && isdigit(c5)) {
-                timeStr = String(c1) + String(c2) + ":" + String(c4) + String(c5);
-                pos = i + 5;
-                foundTime = true;
-                foundCount++;
-                break;
-            }
-        }
-        
-        if (!foundTime) break;
-        
-        // Now extract line number and destination after the time
-        // Skip whitespace and HTML tags
-        while (pos < html.length() && (html[pos] == ' ' || html[pos] == '\t' || 
-                                        html[pos] == '\n' || html[pos] == '\r' || 
-                                        html[pos] == '<')) {
-            if (html[pos] == '<') {
-                // Skip entire tag
-                while (pos < html.length() && html[pos] != '>') pos++;
-                pos++;
-            } else {
-                pos++;
-            }
-        }
-        
-        // Extract line number (should be 1-3 digits)
-        String lineNum = "";
-        while (pos < html.length() && isdigit(html[pos])) {
-            lineNum += html[pos];
-            pos++;
+    if (stop.haveFingerprint && state.fingerprint == stop.fingerprint) {
+        // Same departures as last time: keep the table
+        keepTable(stop);
+        Serial.printf("Departures unchanged (fingerprint %08lx)\n", (unsigned long)state.fingerprint);
+        return FETCH_UNCHANGED;
+    }
+    
+    table.count = 0;
+    bool interned = true;
+    for (uint8_t i = 0; i < state.count; i++) {
+        const DrglRecord& rec = pending[i];
+        Tram& t = table.trams[table.count++];
+        t.line = internString(rec.line);
+        t.dest = internString(rec.dest[0] != '\0' ? rec.dest : "Unknown");
+        t.departs = parseDepartureTime(rec.time);
+        interned = interned && t.line != STR_NONE && t.dest != STR_NONE;
+    }
+    stop.truncated = !parsing;
+    if (interned) {
+        stop.fingerprint = state.fingerprint;
+        stop.haveFingerprint = true;
+    } else {
+        // Some names did not fit the pool: parse the page again after the
+        // next sweep instead of keeping "?" until the departures change
+        forgetPage(stop);
+    }
+    
+    Serial.printf("Upcoming departures at %s: %d%s\n", config.code, table.count,
+                 stop.truncated ? " (table full)" : "");
+    
+    return FETCH_UPDATED;
+}
+
+void reclaimTramStrings(const DepartureTable& shown) {
+    strPoolBeginSweep();
+    for (size_t s = 0; s < STOP_COUNT; s++) {
+        const DepartureTable& table = stopStates[s].table;
+        for (uint8_t i = 0; i < table.count; i++) {
+            strPoolMark(table.trams[i].line);
+            strPoolMark(table.trams[i].dest);
         }
-        
-        // Skip whitespace and tags again
-        while (pos < html.length() && (html[pos] == ' ' || html[pos] == '\t' || 
-                                        html[pos] == '\n' || html[pos] == '\r' || 
-                                        html[pos] == '<')) {
-            if (html[pos] == '<') {
-                while (pos < html.length() && html[pos] != '>') pos++;
-                pos++;
-            } else {
-                pos++;
-            }
+    }
+    for (uint8_t i = 0; i < shown.count; i++) {
+        strPoolMark(shown.trams[i].line);
+        strPoolMark(shown.trams[i].dest);
+    }
+    strPoolSweep();
+}
+
+// Merge every stop's departures within the window into one time-ordered board
+static void mergeStops(DepartureTable& board) {
+    time_t now = time(nullptr);
+    board.count = 0;
+    for (size_t s = 0; s < STOP_COUNT; s++) {
+        const DepartureTable& table = stopStates[s].table;
+        for (uint8_t i = 0; i < table.count; i++) {
+            const Tram& t = table.trams[i];
+            if (tramMinutes(t, now) > DEPARTURE_WINDOW_MIN) continue;
+            
+            // Insertion sort; the board only keeps the earliest MAX_TRAMS
+            int pos = board.count;
+            while (pos > 0 && board.trams[pos - 1].departs > t.departs) pos--;
+            if (pos >= MAX_TRAMS) continue;
+            
+            int last = board.count < MAX_TRAMS ? board.count : MAX_TRAMS - 1;
+            for (int j = last; j > pos; j--) board.trams[j] = board.trams[j - 1];
+            board.trams[pos] = t;
+            if (board.count < MAX_TRAMS) board.count++;
         }
-        
-        // Extract destination (until we hit < or newline)
-        String dest = "";
-        while (pos < html.length() && html[pos] != '<' && html[pos] != '\n' && 
-               html[pos] != '\r' && dest.length() < 50) {
-            dest += html[pos];
-            pos++;
+    }
+}
+
+FetchResult fetchTrams(DepartureTable& table) {
+    lastHttpCode = 0;
+    lastHtmlSize = 0;
+    lastFoundEntries = 0;
+    
+    // Stops share one kept-alive connection, so extra stops cost a round trip
+    // each rather than a handshake each
+    int failed = 0;
+    int notModified = 0;
+    bool updated = false;
+    for (size_t s = 0; s < STOP_COUNT; s++) {
+        FetchResult result;
+        if (!WiFi.isConnected()) {
+            Serial.println("ERROR: WiFi not connected!");
+            result = fetchFailed(stopStates[s]);
+        } else {
+            result = fetchStop(stops[s], stopStates[s]);
         }
         
-        dest.trim();
-        
-        // Calculate minutes from now
-        int mins = parseTimeToMinutes(timeStr);
-        
-        Serial.printf("Found #%d: Time=%s Line=%s Dest=%s (%d min)\n", 
-                     foundCount, timeStr.c_str(), lineNum.c_str(), 
-                     dest.c_str(), mins);
-        
-        // Only add if within next 60 minutes and has valid line number
-        if (mins >= 0 && mins <= 60 && lineNum.length() > 0) {
-            Tram t;
-            t.line = lineNum;
-            t.dest = dest.length() > 0 ? dest : "Unknown";
-            t.mins = mins;
-            trams.push_back(t);
-        }
+        if (result == FETCH_FAILED) failed++;
+        if (result == FETCH_NOT_MODIFIED) notModified++;
+        if (result == FETCH_UPDATED) updated = true;
     }
     
-    lastFoundEntries = trams.size();
-    Serial.printf("Total departures within 60 min: %d\n", lastFoundEntries);
+    mergeStops(table);
+    lastFoundEntries = table.count;
+    Serial.printf("Total departures within %d min: %d (from %d stops)\n", DEPARTURE_WINDOW_MIN,
+                 lastFoundEntries, (int)STOP_COUNT);
     
-    return trams;
+    if (failed == (int)STOP_COUNT) return FETCH_FAILED;
+    if (updated) return FETCH_UPDATED;
+    if (notModified + failed == (int)STOP_COUNT) return FETCH_NOT_MODIFIED;
+    return FETCH_UNCHANGED;
 }
@@ -0,0 +1,56 @@
+#include "band_canvas.h"
+
+void BandCanvas::setWindow(int16_t x, int16_t y, uint16_t w, uint16_t h) {
+    if ((uint32_t)w * h > BAND_PIXELS) h = BAND_PIXELS / w;
+    wx = x;
+    wy = y;
+    ww = w;
+    wh = h;
+}
+
+void BandCanvas::drawPixel(int16_t x, int16_t y, uint16_t color) {
+    x -= wx;
+    y -= wy;
+    if (x < 0 || y < 0 || x >= (int16_t)ww || y >= (int16_t)wh) return;
+    buffer[y * ww + x] = color;
+}
+
+void BandCanvas::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    // Clip to the window once, then fill whole rows
+    int16_t x0 = x > wx ? x : wx;
+    int16_t y0 = y > wy ? y : wy;
+    int16_t x1 = x + w < wx + (int16_t)ww ? x + w : wx + (int16_t)ww;
+    int16_t y1 = y + h < wy + (int16_t)wh ? y + h : wy + (int16_t)wh;
+    if (x0 >= x1 || y0 >= y1) return;
+
+    for (int16_t row = y0; row < y1; row++) {
+        uint16_t* p = buffer + (row - wy) * ww + (x0 - wx);
+        for (int16_t i = x0; i < x1; i++) *p++ = color;
+    }
+}
+
+void BandCanvas::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+    fillRect(x, y, w, 1, color);
+}
+
+void BandCanvas::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+    fillRect(x, y, 1, h, color);
+}
+
+void BandCanvas::fillScreen(uint16_t color) {
+    fillRect(wx, wy, ww, wh, color);
+}
+
+void BandCanvas::flush(Adafruit_SPITFT& display) {
+    flush(display, wx, wy);
+}
+
+void BandCanvas::flush(Adafruit_SPITFT& display, int16_t x, int16_t y) {
+    if (ww == 0 || wh == 0) return;
+    display.startWrite();
+    display.setAddrWindow(x, y, ww, wh);
+    // The ESP32 SPI driver swaps to the panel's big-endian order while
+    // streaming the whole band from its FIFO
+    display.writePixels(buffer, (uint32_t)ww * wh, true);
+    display.endWrite();
+}
@@ -0,0 +1,147 @@
+#include "clock_keeper.h"
+#include "config.h"
+#include <Preferences.h>
+#include <esp_attr.h>
+#include <esp_sntp.h>
+#include <esp_system.h>
+#include <esp_timer.h>
+#include <sys/time.h>
+#include <time.h>
+
+#define CLOCK_RTC_MAGIC 0x434C4B31  // "CLK1"
+
+// Survives every reset except power loss; checked before it is trusted
+struct ClockRtc {
+    uint32_t magic;
+    int64_t epoch;
+    uint32_t check;
+};
+
+RTC_NOINIT_ATTR static ClockRtc rtcClock;
+
+static ClockSource source = CLOCK_NONE;
+static float driftPpm = 0;
+static bool driftKnown = false;
+static unsigned long lastRtcSave = 0;
+static int64_t lastSyncUptimeUs = 0;  // esp_timer at the previous SNTP sync this boot
+static int64_t lastSyncEpochUs = 0;
+
+static uint32_t rtcCheck(const ClockRtc& r) {
+    return r.magic ^ (uint32_t)r.epoch ^ (uint32_t)(r.epoch >> 32) ^ 0xA5A5A5A5;
+}
+
+static int64_t epochUs() {
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    return (int64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+static void logClock(const char* how) {
+    time_t now = time(nullptr);
+    char buf[32];
+    strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S %Z", localtime(&now));
+    Serial.printf("Clock %s: %s\n", how, buf);
+}
+
+// Resync often enough that drift stays below CLOCK_MAX_ERROR_MS
+static uint32_t syncIntervalMs() {
+    if (!driftKnown || fabsf(driftPpm) < 0.1f) return CLOCK_SYNC_MAX_INTERVAL;
+    float ms = CLOCK_MAX_ERROR_MS * 1e6f / fabsf(driftPpm);
+    if (ms < CLOCK_SYNC_MIN_INTERVAL) return CLOCK_SYNC_MIN_INTERVAL;
+    if (ms > CLOCK_SYNC_MAX_INTERVAL) return CLOCK_SYNC_MAX_INTERVAL;
+    return (uint32_t)ms;
+}
+
+static void saveRtc() {
+    rtcClock.magic = CLOCK_RTC_MAGIC;
+    rtcClock.epoch = time(nullptr);
+    rtcClock.check = rtcCheck(rtcClock);
+}
+
+void beginClock() {
+    // Local time follows the rule, DST included, whatever set the clock
+    setenv("TZ", TIME_ZONE, 1);
+    tzset();
+    
+    Preferences prefs;
+    if (prefs.begin("clock", true)) {
+        driftKnown = prefs.isKey("drift");
+        driftPpm = prefs.getFloat("drift", 0);
+        prefs.end();
+    }
+    
+    esp_reset_reason_t reason = esp_reset_reason();
+    if (time(nullptr) > 100000) {
+        // The system kept counting through the reset
+        source = CLOCK_RESTORED;
+        logClock("kept across reset");
+    } else if (reason != ESP_RST_POWERON && rtcClock.magic == CLOCK_RTC_MAGIC &&
+               rtcClock.check == rtcCheck(rtcClock) && rtcClock.epoch > 100000) {
+        // Saved up to CLOCK_RTC_SAVE_INTERVAL before the reset, plus this boot so far
+        int64_t us = (rtcClock.epoch + CLOCK_RTC_SAVE_INTERVAL / 2000) * 1000000LL + esp_timer_get_time();
+        struct timeval tv = { (time_t)(us / 1000000), (suseconds_t)(us % 1000000) };
+        settimeofday(&tv, nullptr);
+        source = CLOCK_RESTORED;
+        logClock("restored from RTC memory");
+    } else {
+        Serial.println("Clock: no saved time, waiting for SNTP");
+    }
+    if (driftKnown) Serial.printf("Clock drift: %.1f ppm\n", driftPpm);
+}
+
+void startClockSync() {
+    static bool started = false;
+    if (started) return;
+    started = true;
+    Serial.println("Syncing time with NTP...");
+    sntp_set_sync_interval(syncIntervalMs());
+    configTzTime(TIME_ZONE, "pool.ntp.org", "time.nist.gov");
+}
+
+void clockSynced() {
+    int64_t uptimeUs = esp_timer_get_time();
+    int64_t nowUs = epochUs();
+    
+    // Between two syncs the clock ran on the crystal alone; what SNTP
+    // corrected over that span is its drift
+    if (lastSyncUptimeUs > 0 && uptimeUs - lastSyncUptimeUs >= CLOCK_DRIFT_MIN_SPAN_MS * 1000LL) {
+        int64_t local = uptimeUs - lastSyncUptimeUs;
+        float ppm = (float)(nowUs - lastSyncEpochUs - local) * 1e6f / (float)local;
+        float previous = driftPpm;
+        driftPpm = driftKnown ? 0.75f * driftPpm + 0.25f * ppm : ppm;
+        driftKnown = true;
+        Serial.printf("Clock drift: %.1f ppm (this span %.1f ppm)\n", driftPpm, ppm);
+        
+        // Flash is only written for a real change
+        if (fabsf(driftPpm - previous) >= 0.5f) {
+            Preferences prefs;
+            if (prefs.begin("clock", false)) {
+                prefs.putFloat("drift", driftPpm);
+                prefs.end();
+            }
+        }
+        // Used from the next scheduled sync on
+        sntp_set_sync_interval(syncIntervalMs());
+    }
+    lastSyncUptimeUs = uptimeUs;
+    lastSyncEpochUs = nowUs;
+    
+    source = CLOCK_SNTP;
+    saveRtc();
+    lastRtcSave = millis();
+    logClock("synced");
+}
+
+void tickClock() {
+    if (millis() - lastRtcSave < CLOCK_RTC_SAVE_INTERVAL) return;
+    lastRtcSave = millis();
+    if (time(nullptr) > 100000) saveRtc();
+}
+
+ClockSource getClockSource() {
+    return source;
+}
+
+float getClockDriftPpm() {
+    return driftPpm;
+}
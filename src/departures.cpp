@@ -0,0 +1,27 @@
+#include "api.h"
+#include "str_pool.h"
+
+// Departure table helpers. Kept apart from the fetch code so the display
+// can be built and tested on the host without the network stack.
+
+const char* tramLine(const Tram& t) { return pooledString(t.line); }
+const char* tramDest(const Tram& t) { return pooledString(t.dest); }
+
+// Whole minutes against the current minute, like the HH:MM on the page
+int minutesUntil(time_t departs, time_t now) {
+    time_t minuteStart = now - (now % 60);
+    return (int)(((int64_t)departs - (int64_t)minuteStart) / 60);
+}
+
+int tramMinutes(const Tram& t, time_t now) {
+    return minutesUntil(t.departs, now);
+}
+
+void pruneDeparted(DepartureTable& table, time_t now) {
+    if (now < 100000) return;  // Clock not set, cannot tell
+    uint8_t kept = 0;
+    for (uint8_t i = 0; i < table.count; i++) {
+        if (tramMinutes(table.trams[i], now) >= 0) table.trams[kept++] = table.trams[i];
+    }
+    table.count = kept;
+}
@@ -1,14 +1,81 @@
 #include "disp.h"
 #include "config.h"
+#include "fingerprint.h"
+#include "band_canvas.h"
+#include "display_meter.h"
+#include "subset_font.h"
+#include "subset_fonts.h"  // Generated into the build directory by scripts/font_subset.py
 #include <SPI.h>
 #include <WiFi.h>
 #include <time.h>
-#include <Fonts/FreeSansBold18pt7b.h>  // Bold font for large tram time
-#include <Fonts/FreeSansBold12pt7b.h>  // Bold font for medium text
-#include <Fonts/FreeSans9pt7b.h>       // Regular font for small text
+#include <stdarg.h>
 
 // Pin definitions from config.h
 Adafruit_ST7735* tft = nullptr;
+static MeteredST7735* meter = nullptr;  // Same object as tft, with SPI cost counters
+
+// Logs the SPI cost of one screen update when it goes out of scope
+struct CostScope {
+    const char* name;
+    CostScope(const char* n) : name(n) { meter->beginCost(); }
+    ~CostScope() { meter->endCost(name); }
+};
+
+// What the quadrant board last drew; any other screen invalidates it
+static bool boardShown = false;
+
+// RAM band the quadrant board and the scrolling list are composed in
+static BandCanvas band(160, 128);
+
+// Hardware scroll state of the departure list, see showTrams()
+#define ST7735_VSCRDEF 0x33  // Scroll area definition
+#define ST7735_VSCSAD  0x37  // Scroll start address
+#define SCROLL_LINES   160   // Visible lines in the scroll area
+#define SCROLL_HIDDEN  2     // Frame memory lines past the screen (162 in total)
+
+static bool listShown = false;
+static uint32_t listFingerprint = 0;
+static uint8_t listCount = 0;
+static Tram listTrams[MAX_TRAMS];  // Copy of what the cards show
+static int listMinutes[MAX_TRAMS];
+static uint16_t scrollAddr = 0;    // Current hardware start line
+static uint16_t scrollPos = 0;     // Strip column shown at the left edge
+static unsigned long lastScrollStep = 0;
+static DisplayCost lapCost = {};   // Scroll frames since scrollAddr was last 0
+
+static void addCost(DisplayCost& total, const DisplayCost& c) {
+    total.transactions += c.transactions;
+    total.windows += c.windows;
+    total.pixels += c.pixels;
+    total.commands += c.commands;
+    total.bytes += c.bytes;
+    total.us += c.us;
+}
+
+static uint16_t stripWidth() {
+    return listCount * TRAM_CARD_WIDTH;
+}
+
+static bool listScrolls() {
+    return stripWidth() > SCROLL_LINES;
+}
+
+static void setScrollStart(uint16_t line) {
+    uint8_t data[2] = { (uint8_t)(line >> 8), (uint8_t)line };
+    meter->sendCommand(ST7735_VSCSAD, data, 2);
+}
+
+// Other screens need the panel back at its unscrolled position
+static void stopTramScroll() {
+    if (scrollAddr != 0) setScrollStart(0);
+    scrollAddr = 0;
+    listShown = false;
+}
+
+
+// Board restored from flash and not yet confirmed by a fetch
+static bool boardStale = false;
+static time_t staleAsOf = 0;
 
 // PWM settings for backlight brightness control
 #define BACKLIGHT_PWM_CHANNEL 0
@@ -59,7 +126,8 @@ void initDisplay() {
     delay(100);
     
     Serial.println("Creating Adafruit_ST7735 object...");
-    tft = new Adafruit_ST7735(TFT_CS, TFT_DC, TFT_RST);
+    meter = new MeteredST7735(TFT_CS, TFT_DC, TFT_RST);
+    tft = meter;
     Serial.println("Display object created");
     delay(50);
     
@@ -77,6 +145,11 @@ void initDisplay() {
     Serial.println("Setting rotation to 3 (landscape 160x128)...");
     tft->setRotation(3);
     
+    // Whole visible height is one scroll area; the two extra frame memory
+    // lines sit in the bottom fixed area so they never scroll into view
+    uint8_t scrollArea[6] = { 0, 0, 0, SCROLL_LINES, 0, SCROLL_HIDDEN };
+    meter->sendCommand(ST7735_VSCRDEF, scrollArea, 6);
+    
     // Clear screen to BLACK
     Serial.println("Clearing screen to BLACK...");
     tft->fillScreen(ST77XX_BLACK);
@@ -86,7 +159,11 @@ void initDisplay() {
     Serial.printf("Display size: %dx%d\n", tft->width(), tft->height());
 }
 
-void showDebugInfo(String msg, int httpCode, int htmlSize, int found) {
+void showDebugInfo(const char* msg, int httpCode, int htmlSize, int found) {
+    CostScope cost("showDebugInfo");
+    stopTramScroll();
+    boardShown = false;
+    
     // ALWAYS fill entire screen with black first
     tft->fillScreen(ST77XX_BLACK);
     
@@ -131,67 +208,182 @@ void showDebugInfo(String msg, int httpCode, int htmlSize, int found) {
     }
 }
 
-void showMessage(String msg) {
-    Serial.printf("Display: %s\n", msg.c_str());
+void showMessage(const char* msg) {
+    Serial.printf("Display: %s\n", msg);
     int code = getLastHttpCode();
     int size = getLastHtmlSize();
     int found = getLastFoundEntries();
     showDebugInfo(msg, code, size, found);
 }
 
-void showTrams(std::vector<Tram> trams) {
-    // Always fill entire screen with black
-    tft->fillScreen(ST77XX_BLACK);
+// ========== SCROLLING DEPARTURE LIST ==========
+// The ST7735 scrolls along its 160-line axis, which is horizontal in
+// rotation 3, so the list is a row of departure cards that glides
+// sideways. A scroll step is one VSCSAD write plus one newly drawn
+// 1x128 column; the other 159 columns are moved by the panel itself.
+
+// Print only the characters of s that touch columns [clipX0, clipX1).
+// Classic-font cells are 6 * size wide, so the rest can be skipped unseen.
+static void printClipped(Adafruit_GFX& g, int16_t x, int16_t y, uint8_t size, const char* s,
+                         int16_t clipX0, int16_t clipX1) {
+    int16_t cell = 6 * size;
+    g.setTextSize(size);
+    for (int i = 0; s[i] != '\0'; i++) {
+        int16_t cx = x + i * cell;
+        if (cx + cell <= clipX0) continue;
+        if (cx >= clipX1) break;
+        g.setCursor(cx, y);
+        g.print(s[i]);
+    }
+}
+
+// Draw the part of card k that falls in columns [clipX0, clipX1), with the
+// card's left edge at x0. A scroll step needs one column, so only the
+// glyphs crossing it are drawn rather than the whole card.
+static void drawTramCard(Adafruit_GFX& g, int16_t x0, uint8_t k, int16_t clipX0, int16_t clipX1) {
+    const Tram& t = listTrams[k];
+    char text[16];
+    
+    // Line number (yellow, top)
+    g.setTextColor(ST77XX_YELLOW);
+    printClipped(g, x0 + 6, 6, 2, tramLine(t), clipX0, clipX1);
+    
+    // Minutes (green, large) with a small "m"
+    g.setTextColor(ST77XX_GREEN);
+    int digits = snprintf(text, sizeof(text), "%d", listMinutes[k]);
+    printClipped(g, x0 + 6, 30, 3, text, clipX0, clipX1);
+    printClipped(g, x0 + 6 + 18 * digits, 30, 1, "m", clipX0, clipX1);
+    
+    // Destination (white), wrapped over up to three lines of 12 characters
+    g.setTextColor(ST77XX_WHITE);
+    const char* dest = tramDest(t);
+    size_t len = strlen(dest);
+    for (int line = 0; line < 3 && (size_t)line * 12 < len; line++) {
+        snprintf(text, sizeof(text), "%.12s", dest + line * 12);
+        printClipped(g, x0 + 4, 66 + line * 11, 1, text, clipX0, clipX1);
+    }
+    
+    // Departure clock time (gray, bottom)
+    time_t departs = t.departs;
+    struct tm ti;
+    localtime_r(&departs, &ti);
+    g.setTextColor(COLOR_GRAY);
+    snprintf(text, sizeof(text), "%02d:%02d", ti.tm_hour, ti.tm_min);
+    printClipped(g, x0 + 6, 112, 1, text, clipX0, clipX1);
+    
+    // Card separator on the right edge
+    int16_t edge = x0 + TRAM_CARD_WIDTH - 1;
+    if (edge >= clipX0 && edge < clipX1) g.drawFastVLine(edge, 0, 128, COLOR_GRAY);
+}
+
+// Frame memory column that screen column x currently shows. In rotation 3
+// (MADCTL MX|MV) screen x is frame memory row x, and VSCSAD makes panel
+// line n show memory row start + n, so raising the start moves the
+// picture towards x = 0.
+static uint16_t memoryColumn(uint16_t x) {
+    return (x + scrollAddr) % SCROLL_LINES;
+}
+
+// Compose strip column c in RAM and send it to screen column x
+static void drawStripColumn(uint16_t c, uint16_t x) {
+    uint8_t k = c / TRAM_CARD_WIDTH;
+    band.setWindow(0, 0, 1, 128);
+    band.fillScreen(ST77XX_BLACK);
+    drawTramCard(band, -(int16_t)(c % TRAM_CARD_WIDTH), k, 0, 1);
+    band.flush(*tft, memoryColumn(x), 0);
+}
+
+bool showTrams(const DepartureTable& trams) {
+    CostScope cost("showTrams");
+    boardShown = false;
     
     if (trams.empty()) {
+        stopTramScroll();
         showMessage("No trams");
-        return;
+        return true;
     }
     
-    Serial.printf("Displaying %d trams\n", trams.size());
-    
-    // Display title at top
-    tft->setTextColor(ST77XX_WHITE);
-    tft->setTextSize(1);
-    tft->setCursor(2, 2);
-    tft->println(STOP_NAME);
-    
-    // Draw separator line
-    tft->drawFastHLine(0, 12, 160, ST77XX_BLUE);
-    
-    // Show up to 5 trams (160x128 landscape)
-    int y = 18;
-    for (size_t i = 0; i < trams.size() && i < 5; i++) {
-        // Line number (yellow, left)
-        tft->setTextColor(ST77XX_YELLOW);
-        tft->setTextSize(2);
-        tft->setCursor(2, y);
-        tft->print(trams[i].line);
-        
-        // Destination (white, middle)
-        tft->setTextColor(ST77XX_WHITE);
-        tft->setTextSize(1);
-        tft->setCursor(30, y + 4);
-        String d = trams[i].dest;
-        if (d.length() > 15) d = d.substring(0, 15);
-        tft->print(d);
-        
-        // Minutes (green, right)
-        tft->setTextColor(ST77XX_GREEN);
-        tft->setTextSize(2);
-        int minsWidth = (trams[i].mins < 10) ? 12 : 24;
-        tft->setCursor(160 - minsWidth - 15, y);
-        tft->print(trams[i].mins);
-        tft->setTextSize(1);
-        tft->setCursor(160 - 12, y + 4);
-        tft->print("m");
-        
-        y += 22;
+    // Rebuild the strip only when a card would look different
+    time_t now = time(nullptr);
+    uint32_t h = fingerprint(&trams.count, sizeof(trams.count));
+    for (size_t i = 0; i < trams.size(); i++) {
+        int card[4] = { trams[i].line, trams[i].dest, (int)trams[i].departs, tramMinutes(trams[i], now) };
+        h = fingerprint(card, sizeof(card), h);
+    }
+    if (listShown && h == listFingerprint) return false;
+    
+    bool wasShown = listShown;
+    listFingerprint = h;
+    listCount = trams.count;
+    for (uint8_t i = 0; i < listCount; i++) {
+        listTrams[i] = trams.trams[i];
+        listMinutes[i] = tramMinutes(trams[i], now);
+    }
+    if (!wasShown) {
+        stopTramScroll();
+        scrollPos = 0;
+        lastScrollStep = millis();
+    }
+    if (!listScrolls()) {
+        // Everything fits: stand still at the start of the strip
+        if (scrollAddr != 0) setScrollStart(0);
+        scrollAddr = 0;
+        scrollPos = 0;
+    }
+    if (scrollPos >= stripWidth()) scrollPos = 0;
+    listShown = true;
+    
+    Serial.printf("Displaying %u trams as scrolling cards\n", (unsigned)trams.size());
+    
+    // Redraw every visible column where it currently sits in frame memory
+    for (uint16_t x = 0; x < SCROLL_LINES; x++) {
+        uint16_t c = scrollPos + x;
+        if (listScrolls()) {
+            c %= stripWidth();
+        } else if (c >= stripWidth()) {
+            band.setWindow(0, 0, 1, 128);
+            band.fillScreen(ST77XX_BLACK);
+            band.flush(*tft, memoryColumn(x), 0);
+            continue;
+        }
+        drawStripColumn(c, x);
+    }
+    return true;
+}
+
+void tickTramScroll() {
+    if (!listShown || !listScrolls()) return;
+    
+    // Catch up after a slow loop pass, but never by more than a few frames
+    unsigned long elapsed = millis() - lastScrollStep;
+    if (elapsed < TRAM_SCROLL_FRAME_MS) return;
+    uint32_t steps = elapsed / TRAM_SCROLL_FRAME_MS;
+    if (steps > 4) steps = 4;
+    lastScrollStep = millis();
+    
+    for (uint32_t i = 0; i < steps; i++) {
+        meter->beginCost();
+        scrollAddr = (scrollAddr + 1) % SCROLL_LINES;
+        scrollPos = (scrollPos + 1) % stripWidth();
+        setScrollStart(scrollAddr);
+        // The column that left on the left comes back on the right
+        drawStripColumn((scrollPos + SCROLL_LINES - 1) % stripWidth(), SCROLL_LINES - 1);
+        meter->endCost(nullptr);
+        addCost(lapCost, meter->lastCost());
+        // One line per trip round the frame memory rather than per frame
+        if (scrollAddr == 0) {
+            MeteredST7735::logCost("tickTramScroll (lap)", lapCost);
+            lapCost = {};
+        }
     }
 }
 
 // New function to show trams with weather and sensor data
-void showTramsWithSensor(std::vector<Tram> trams, const sensor_data_t& sensorData) {
+void showTramsWithSensor(const DepartureTable& trams, const sensor_data_t& sensorData) {
+    CostScope cost("showTramsWithSensor");
+    stopTramScroll();
+    boardShown = false;
+    
     // Clear screen
     tft->fillScreen(ST77XX_BLACK);
     
@@ -204,11 +396,11 @@ void showTramsWithSensor(std::vector<Tram> trams, const sensor_data_t& sensorDat
     tft->drawFastHLine(0, 64, 160, COLOR_GRAY);     // Horizontal separator (top | bottom)
     
     // ===== LAYOUT: TOP LEFT = TRAMS (0-80, 0-64) =====
-    // Header: "Tram 17" in WHITE
+    // Header: board title in WHITE
     tft->setTextColor(ST77XX_WHITE);
     tft->setTextSize(1);
     tft->setCursor(3, 3);
-    tft->print("Tram 17");
+    tft->print(BOARD_TITLE);
     
     // Current time (far right of entire screen)
     time_t now = time(nullptr);
@@ -224,9 +416,7 @@ void showTramsWithSensor(std::vector<Tram> trams, const sensor_data_t& sensorDat
     
     // First tram (LARGE RED BOLD with custom font, NO "m" label, CENTERED properly)
     if (trams.size() > 0) {
-        tft->setTextColor(ST77XX_RED);
-        tft->setFont(&FreeSansBold18pt7b);  // Use bold font
-        int firstTime = trams[0].mins;
+        int firstTime = tramMinutes(trams[0], now);
         
         // Proper centering based on digit count in LEFT section only (0-48 width, leaving space for right times)
         int centerX;
@@ -238,13 +428,10 @@ void showTramsWithSensor(std::vector<Tram> trams, const sensor_data_t& sensorDat
             centerX = 8;  // Double digit - slightly left to fit
         }
         
-        tft->setCursor(centerX, 45);  // Y is baseline position with custom fonts
-        if (firstTime == 0) {
-            tft->print("NOW");
-        } else {
-            tft->printf("%d", firstTime);
-        }
-        tft->setFont();  // Reset to default font
+        // Y is baseline position with custom fonts
+        char text[8];
+        snprintf(text, sizeof(text), firstTime == 0 ? "NOW" : "%d", firstTime);
+        drawSubsetText(*tft, &FreeSansBold18pt7bSubset, centerX, 45, ST77XX_RED, text);
     }
     
     // Next 3 tram times (smaller, to the right, more spacing from large number)
@@ -253,15 +440,15 @@ void showTramsWithSensor(std::vector<Tram> trams, const sensor_data_t& sensorDat
     
     if (trams.size() > 1) {
         tft->setCursor(56, 22);
-        tft->printf("%dm", trams[1].mins);
+        tft->printf("%dm", tramMinutes(trams[1], now));
     }
     if (trams.size() > 2) {
         tft->setCursor(56, 36);
-        tft->printf("%dm", trams[2].mins);
+        tft->printf("%dm", tramMinutes(trams[2], now));
     }
     if (trams.size() > 3) {
         tft->setCursor(56, 50);
-        tft->printf("%dm", trams[3].mins);
+        tft->printf("%dm", tramMinutes(trams[3], now));
     }
     
     // ===== LAYOUT: TOP RIGHT = WEATHER (80-160, 0-64) =====
@@ -327,43 +514,200 @@ void showTramsWithSensor(std::vector<Tram> trams, const sensor_data_t& sensorDat
     Serial.println("Display updated: Trams + Sensor (quadrant layout)");
 }
 
-// Enhanced function to show trams with weather AND sensor data from multiple sensors
-void showTramsWithWeatherAndSensor(std::vector<Tram> trams, const Weather& weather, const sensor_data_t& olgaData, const sensor_data_t& aeData, bool hasOlga, bool hasAE) {
-    // Clear screen
-    tft->fillScreen(ST77XX_BLACK);
-    
-    if (trams.empty()) {
-        showMessage("No trams");
+void setBoardStale(bool stale, time_t asOf) {
+    boardStale = stale;
+    staleAsOf = stale ? asOf : 0;
+}
+
+// Clock the board is drawn at. Until NTP has set the clock a stale board
+// is shown as it was when saved rather than counted from 1970.
+static time_t boardNow() {
+    time_t now = time(nullptr);
+    if (now < 100000 && boardStale && staleAsOf > 0) return staleAsOf;
+    return now;
+}
+
+// ========== RETAINED QUADRANT BOARD ==========
+// Every piece of text that can change is a widget that remembers what it
+// drew and where. An update clears and redraws only the widgets whose
+// content changed, instead of repainting all 160x128 pixels.
+
+enum BoardWidgetId {
+    W_TITLE, W_CLOCK,
+    W_FIRST, W_NEXT1, W_NEXT2, W_NEXT3,
+    W_TEMP_HIGH, W_TEMP, W_TEMP_UNIT, W_TEMP_LOW, W_WIND, W_WEATHER1, W_WEATHER2,
+    W_SENSOR_PAGE,
+    W_SENSORS,  // Name, moisture, battery and moisture trend for each sensor cell
+    W_COUNT = W_SENSORS + 4 * BOARD_SENSOR_CELLS
+};
+
+#define SENSOR_CELL_WIDTH (160 / BOARD_SENSOR_CELLS)
+#define TREND_Y 115       // Sparkline below the battery row
+#define TREND_HEIGHT 11
+
+struct BoardWidget {
+    int16_t x, y;      // Bounds of what is on screen
+    uint16_t w, h;     // w == 0: nothing on screen
+    uint32_t key;      // Fingerprint of the drawn text and style
+};
+
+// Screen rectangle that has to be composed again
+struct DirtyRect {
+    int16_t x, y;
+    uint16_t w, h;
+};
+
+// What a widget should show this frame
+struct WidgetContent {
+    int16_t x, y;            // Cursor; the baseline for custom fonts
+    const SubsetFont* font;  // nullptr = built-in 6x8 font
+    uint16_t color;
+    char text[16];           // Empty = draw nothing
+    uint8_t trend[BOARD_TREND_POINTS];  // Sparkline 0-100 instead of text, HISTORY_NO_DATA = gap
+    uint8_t trendPoints;
+    uint8_t trendWidth;                 // 0 = not a sparkline
+};
+
+static BoardWidget widgets[W_COUNT];
+static WidgetContent content[W_COUNT];
+
+struct BoardRenderStats {
+    uint32_t frames;
+    uint32_t fullFrames;
+    uint32_t lastWidgets;  // Widgets changed by the last update
+    uint32_t lastUs;       // Duration of the last update
+    uint32_t lastFullUs;   // Duration of the last full-board paint
+};
+static BoardRenderStats renderStats;
+
+static void setContent(BoardWidgetId id, int16_t x, int16_t y, const SubsetFont* font, uint16_t color, const char* fmt, ...) {
+    WidgetContent& c = content[id];
+    c.x = x;
+    c.y = y;
+    c.font = font;
+    c.color = color;
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(c.text, sizeof(c.text), fmt, args);
+    va_end(args);
+}
+
+// A sparkline of `points` values across `width` pixels at x, y (top left).
+// Nothing is drawn when every point is a gap.
+static void setTrendContent(BoardWidgetId id, int16_t x, int16_t y, uint8_t width, uint16_t color,
+                            const uint8_t* points, uint8_t count) {
+    bool any = false;
+    for (uint8_t p = 0; p < count; p++) any = any || points[p] != HISTORY_NO_DATA;
+    if (!any || count < 2) return;
+    WidgetContent& c = content[id];
+    c.x = x;
+    c.y = y;
+    c.color = color;
+    c.trendWidth = width;
+    c.trendPoints = count;
+    memcpy(c.trend, points, count);
+}
+
+static void clearContent(BoardWidgetId id) {
+    memset(&content[id], 0, sizeof(WidgetContent));
+}
+
+static bool hasContent(const WidgetContent& c) {
+    return c.text[0] != '\0' || c.trendWidth > 0;
+}
+
+static uint32_t contentKey(const WidgetContent& c) {
+    uint32_t h = fingerprint(&c.x, sizeof(c.x));
+    h = fingerprint(&c.y, sizeof(c.y), h);
+    h = fingerprint(&c.font, sizeof(c.font), h);
+    h = fingerprint(&c.color, sizeof(c.color), h);
+    if (c.trendWidth > 0) {
+        h = fingerprint(&c.trendWidth, sizeof(c.trendWidth), h);
+        h = fingerprint(c.trend, c.trendPoints, h);
+    }
+    return fingerprintStr(c.text, h);
+}
+
+static bool overlaps(int16_t ax, int16_t ay, uint16_t aw, uint16_t ah, int16_t x, int16_t y, uint16_t w, uint16_t h) {
+    return aw > 0 && w > 0 &&
+           ax < x + (int16_t)w && x < ax + (int16_t)aw &&
+           ay < y + (int16_t)h && y < ay + (int16_t)ah;
+}
+
+// Grow r to also cover the given rectangle
+static void unite(DirtyRect& r, int16_t x, int16_t y, uint16_t w, uint16_t h) {
+    if (w == 0) return;
+    if (r.w == 0) {
+        r = { x, y, w, h };
         return;
     }
-    
+    int16_t x1 = max((int16_t)(r.x + r.w), (int16_t)(x + w));
+    int16_t y1 = max((int16_t)(r.y + r.h), (int16_t)(y + h));
+    r.x = min(r.x, x);
+    r.y = min(r.y, y);
+    r.w = x1 - r.x;
+    r.h = y1 - r.y;
+}
+
+// Join the points with lines, lifting the pen over gaps
+static void drawTrend(Adafruit_GFX& g, const WidgetContent& c) {
+    int16_t lastX = 0, lastY = -1;
+    for (uint8_t p = 0; p < c.trendPoints; p++) {
+        if (c.trend[p] == HISTORY_NO_DATA) {
+            lastY = -1;
+            continue;
+        }
+        int16_t x = c.x + p * (c.trendWidth - 1) / (c.trendPoints - 1);
+        int16_t y = c.y + TREND_HEIGHT - 1 - min((int)c.trend[p], 100) * (TREND_HEIGHT - 1) / 100;
+        if (lastY < 0) {
+            g.drawPixel(x, y, c.color);
+        } else {
+            g.drawLine(lastX, lastY, x, y, c.color);
+        }
+        lastX = x;
+        lastY = y;
+    }
+}
+
+// Labels and separators never change
+static void drawBoardStatic(Adafruit_GFX& g) {
     // ===== SEPARATOR LINES (GRAY, NO OUTER BORDER) =====
-    tft->drawFastHLine(0, 64, 160, COLOR_GRAY);     // Horizontal separator (top | bottom)
+    g.drawFastHLine(0, 64, 160, COLOR_GRAY);     // Horizontal separator (top | bottom)
+    g.drawFastHLine(0, 12, 160, COLOR_GRAY);     // Underline below header
+    
+    // ===== LAYOUT: BOTTOM = SENSOR DATA IN EQUAL CELLS (0-160, 64-128) =====
+    g.setFont();
+    g.setTextSize(1);
+    g.setTextColor(ST77XX_WHITE);
+    for (int i = 0; i < BOARD_SENSOR_CELLS; i++) {
+        int16_t x0 = i * SENSOR_CELL_WIDTH;
+        if (i > 0) g.drawFastVLine(x0, 64, 64, COLOR_GRAY);
+        g.setCursor(x0 + 4, 90);
+        g.print("S:");
+        g.setCursor(x0 + 4, 105);
+        g.print("B:");
+    }
+}
+
+// Work out what every widget shows for this frame
+static void layoutBoard(const DepartureTable& trams, const Weather& weather, const SensorCell* cells, uint8_t page, uint8_t pages) {
+    for (int i = 0; i < W_COUNT; i++) clearContent((BoardWidgetId)i);
     
     // ===== LAYOUT: TOP LEFT = TRAMS (0-80, 0-64) =====
-    // Header: "Tram 17" in WHITE
-    tft->setTextColor(ST77XX_WHITE);
-    tft->setTextSize(1);
-    tft->setCursor(3, 3);
-    tft->print("Tram 17");
+    // Header: board title in WHITE, GRAY while showing a restored snapshot
+    uint16_t headerColor = boardStale ? COLOR_GRAY : ST77XX_WHITE;
+    setContent(W_TITLE, 3, 3, nullptr, headerColor, boardStale ? "%s *" : "%s", BOARD_TITLE);
     
     // Current time (far right of entire screen)
-    time_t now = time(nullptr);
+    time_t now = boardNow();
     if (now > 100000) {
         struct tm* ti = localtime(&now);
-        tft->setTextColor(ST77XX_WHITE);
-        tft->setCursor(125, 3);  // Far right side
-        tft->printf("%02d:%02d", ti->tm_hour, ti->tm_min);
+        setContent(W_CLOCK, 125, 3, nullptr, headerColor, "%02d:%02d", ti->tm_hour, ti->tm_min);
     }
     
-    // Gray underline across ENTIRE screen (below header)
-    tft->drawFastHLine(0, 12, 160, COLOR_GRAY);
-    
     // First tram (LARGE RED BOLD with custom font, NO "m" label, CENTERED properly)
     if (trams.size() > 0) {
-        tft->setTextColor(ST77XX_RED);
-        tft->setFont(&FreeSansBold18pt7b);  // Use bold font
-        int firstTime = trams[0].mins;
+        int firstTime = tramMinutes(trams[0], now);
         
         // Proper centering based on digit count in LEFT section only (0-48 width, leaving space for right times)
         int centerX;
@@ -375,150 +719,194 @@ void showTramsWithWeatherAndSensor(std::vector<Tram> trams, const Weather& weath
             centerX = 8;  // Double digit - slightly left to fit
         }
         
-        tft->setCursor(centerX, 45);  // Y is baseline position with custom fonts
+        // Y is baseline position with custom fonts
         if (firstTime == 0) {
-            tft->print("NOW");
+            setContent(W_FIRST, centerX, 45, &FreeSansBold18pt7bSubset, ST77XX_RED, "NOW");
         } else {
-            tft->printf("%d", firstTime);
+            setContent(W_FIRST, centerX, 45, &FreeSansBold18pt7bSubset, ST77XX_RED, "%d", firstTime);
         }
-        tft->setFont();  // Reset to default font
     }
     
     // Next 3 tram times (smaller, to the right, more spacing from large number)
-    tft->setTextColor(ST77XX_WHITE);
-    tft->setTextSize(1);
-    
-    if (trams.size() > 1) {
-        tft->setCursor(56, 22);
-        tft->printf("%dm", trams[1].mins);
-    }
-    if (trams.size() > 2) {
-        tft->setCursor(56, 36);
-        tft->printf("%dm", trams[2].mins);
-    }
-    if (trams.size() > 3) {
-        tft->setCursor(56, 50);
-        tft->printf("%dm", trams[3].mins);
+    for (size_t i = 1; i < trams.size() && i <= 3; i++) {
+        setContent((BoardWidgetId)(W_NEXT1 + i - 1), 56, 8 + 14 * i, nullptr, ST77XX_WHITE,
+                   "%dm", tramMinutes(trams[i], now));
     }
     
     // ===== LAYOUT: TOP RIGHT = WEATHER (80-160, 0-64) =====
     if (weather.valid) {
         // High temperature (red, smaller) - aligned with top of large temp
-        tft->setTextColor(ST77XX_RED);
-        tft->setTextSize(1);
-        tft->setCursor(135, 18);
-        tft->print("H:");
-        tft->printf("%.0f", weather.tempMax);
-        
+        setContent(W_TEMP_HIGH, 135, 18, nullptr, ST77XX_RED, "H:%.0f", weather.tempMax);
         // Current temperature (white, with bold font) - sized to fit without touching top line
-        tft->setTextColor(ST77XX_WHITE);
-        tft->setFont(&FreeSansBold12pt7b);  // 12pt for proper fit (5% smaller than 18pt)
-        tft->setCursor(90, 33);  // Baseline positioning
-        tft->printf("%.0f", weather.temp);
-        tft->setFont();
-        tft->setTextSize(1);
-        tft->setCursor(122, 26);
-        tft->print("C");
-        
+        setContent(W_TEMP, 90, 33, &FreeSansBold12pt7bSubset, ST77XX_WHITE, "%.0f", weather.temp);
+        setContent(W_TEMP_UNIT, 122, 26, nullptr, ST77XX_WHITE, "C");
         // Low temperature (cyan, smaller) - bottom aligned with temp baseline
-        tft->setTextColor(ST77XX_CYAN);
-        tft->setCursor(135, 33);
-        tft->print("L:");
-        tft->printf("%.0f", weather.tempMin);
-        
+        setContent(W_TEMP_LOW, 135, 33, nullptr, ST77XX_CYAN, "L:%.0f", weather.tempMin);
         // Wind speed (white) - centered within weather block width, with space before m/s
-        tft->setTextColor(ST77XX_WHITE);
-        tft->setTextSize(1);
-        tft->setCursor(98, 50);
-        tft->printf("%.1f ", weather.windSpeed);  // Added space before m/s
-        tft->print("m/s");
+        setContent(W_WIND, 98, 50, nullptr, ST77XX_WHITE, "%.1f m/s", weather.windSpeed);
     } else {
-        tft->setTextColor(ST77XX_YELLOW);
-        tft->setTextSize(1);
-        tft->setCursor(88, 25);
-        tft->print("Weather");
-        tft->setCursor(88, 37);
-        tft->print("Loading");
+        setContent(W_WEATHER1, 88, 25, nullptr, ST77XX_YELLOW, "Weather");
+        setContent(W_WEATHER2, 88, 37, nullptr, ST77XX_YELLOW, "Loading");
     }
     
-    // ===== LAYOUT: BOTTOM = SENSOR DATA IN 3 EQUAL SECTIONS (0-160, 64-128) =====
-    // Section width: 160/3 = ~53 pixels each
+    // ===== SENSOR VALUES =====
+    for (int i = 0; i < BOARD_SENSOR_CELLS; i++) {
+        const SensorCell& cell = cells[i];
+        int16_t x0 = i * SENSOR_CELL_WIDTH;
+        BoardWidgetId name = (BoardWidgetId)(W_SENSORS + 4 * i);
+        BoardWidgetId soil = (BoardWidgetId)(name + 1);
+        BoardWidgetId batt = (BoardWidgetId)(name + 2);
+        BoardWidgetId trend = (BoardWidgetId)(name + 3);
+        if (cell.name == nullptr) {
+            setContent(name, x0 + (SENSOR_CELL_WIDTH - 18) / 2, 73, nullptr, COLOR_GRAY, "---");
+            setContent(soil, x0 + 20, 90, nullptr, COLOR_GRAY, "--");
+            setContent(batt, x0 + 20, 105, nullptr, COLOR_GRAY, "--");
+            continue;
+        }
+        // Centred, cut to what fits in the cell
+        int len = min((int)strlen(cell.name), (SENSOR_CELL_WIDTH - 2) / 6);
+        setContent(name, x0 + (SENSOR_CELL_WIDTH - 6 * len) / 2, 73, nullptr, ST77XX_GREEN, "%.*s", len, cell.name);
+        if (cell.fresh) {
+            setContent(soil, x0 + 20, 90, nullptr, ST77XX_WHITE, "%d%%", cell.data.soilMoisture);
+            setContent(batt, x0 + 20, 105, nullptr, ST77XX_WHITE, "%d%%", cell.data.batteryPercent);
+        } else {
+            setContent(soil, x0 + 20, 90, nullptr, ST77XX_WHITE, "--");
+            setContent(batt, x0 + 20, 105, nullptr, ST77XX_WHITE, "--");
+        }
+        // Moisture over the last day; the last cell leaves room for the page number
+        int16_t trendRight = x0 + SENSOR_CELL_WIDTH - 4;
+        if (pages > 1 && i == BOARD_SENSOR_CELLS - 1) trendRight = 160 - 6 * 3 - 4;
+        setTrendContent(trend, x0 + 4, TREND_Y, trendRight - (x0 + 4), cell.fresh ? ST77XX_CYAN : COLOR_GRAY,
+                        cell.trend, cell.trendPoints);
+    }
+    if (pages > 1) {
+        setContent(W_SENSOR_PAGE, 160 - 6 * 3 - 2, 119, nullptr, COLOR_GRAY, "%u/%u", page + 1, pages);
+    }
+}
+
+// Draw every part of the board that touches the rectangle. Widgets are
+// drawn whole; a band canvas clips them, the panel simply gets them again.
+static void composeBoard(Adafruit_GFX& g, const DirtyRect& r, bool withStatic) {
+    g.fillRect(r.x, r.y, r.w, r.h, ST77XX_BLACK);
+    if (withStatic) drawBoardStatic(g);
+    
+    for (int i = 0; i < W_COUNT; i++) {
+        const BoardWidget& w = widgets[i];
+        const WidgetContent& c = content[i];
+        if (!hasContent(c) || !overlaps(w.x, w.y, w.w, w.h, r.x, r.y, r.w, r.h)) continue;
+        if (c.trendWidth > 0) {
+            drawTrend(g, c);
+            continue;
+        }
+        if (c.font != nullptr) {
+            // Large digits are decoded as runs instead of rasterized bit by bit
+            drawSubsetText(g, c.font, c.x, c.y, c.color, c.text);
+            continue;
+        }
+        g.setTextSize(1);
+        g.setTextColor(c.color);
+        g.setCursor(c.x, c.y);
+        g.print(c.text);
+    }
+}
+
+// Put one rectangle of the board on the panel
+static void flushRect(const DirtyRect& r, bool full) {
+#if DISPLAY_BANDED
+    // Compose in RAM a band at a time, each sent as a single transfer.
+    // The band holds no old pixels, so the static frame is always redrawn.
+    (void)full;
+    uint16_t rows = BAND_PIXELS / r.w;
+    for (int16_t y = r.y; y < r.y + (int16_t)r.h; y += rows) {
+        uint16_t h = min((int)rows, r.y + r.h - y);
+        band.setWindow(r.x, y, r.w, h);
+        composeBoard(band, { r.x, y, r.w, h }, true);
+        band.flush(*tft);
+    }
+#else
+    // Straight to the panel, one transaction per glyph and line
+    composeBoard(*tft, r, full);
+#endif
+}
+
+bool showTramsWithWeatherAndSensor(const DepartureTable& trams, const Weather& weather, const SensorCell* cells, uint8_t page, uint8_t pages) {
+    CostScope cost("showTramsWithWeatherAndSensor");
+    if (trams.empty()) {
+        showMessage("No trams");
+        return true;
+    }
     
-    // Gray separators between sections
-    tft->drawFastVLine(53, 64, 64, COLOR_GRAY);   // After section 1
-    tft->drawFastVLine(106, 64, 64, COLOR_GRAY);  // After section 2
+    unsigned long start = micros();
     
-    // SECTION 1 (0-53): "Olga" sensor
-    tft->setTextColor(ST77XX_GREEN);
-    tft->setTextSize(1);
-    tft->setCursor(10, 73);
-    tft->print("Olga");
+    // Coming from another screen: repaint everything once
+    bool full = !boardShown;
+    if (full) {
+        stopTramScroll();
+        memset(widgets, 0, sizeof(widgets));
+        boardShown = true;
+    }
     
-    if (hasOlga) {
-        tft->setTextColor(ST77XX_WHITE);
-        tft->setCursor(4, 90);
-        tft->print("S:");
-        tft->setCursor(20, 90);
-        tft->printf("%d%%", olgaData.soilMoisture);
+    layoutBoard(trams, weather, cells, page, pages);
+    
+    // A changed widget dirties both where its old text was and where the
+    // new text goes; overlapping areas are merged so nothing is sent twice
+    DirtyRect dirty[W_COUNT];
+    int dirtyCount = 0;
+    uint32_t changed = 0;
+    for (int i = 0; i < W_COUNT; i++) {
+        const WidgetContent& c = content[i];
+        uint32_t key = contentKey(c);
+        BoardWidget& w = widgets[i];
+        if (!full && key == w.key) continue;
+        changed++;
         
-        tft->setCursor(4, 105);
-        tft->print("B:");
-        tft->setCursor(20, 105);
-        tft->printf("%d%%", olgaData.batteryPercent);
-    } else {
-        tft->setTextColor(ST77XX_WHITE);
-        tft->setCursor(4, 90);
-        tft->print("S:");
-        tft->setCursor(20, 90);
-        tft->print("--");
+        DirtyRect r = { w.x, w.y, w.w, w.h };
+        w.key = key;
+        w.w = 0;
+        if (c.trendWidth > 0) {
+            w.x = c.x;
+            w.y = c.y;
+            w.w = c.trendWidth;
+            w.h = TREND_HEIGHT;
+        } else if (c.text[0] != '\0' && c.font != nullptr) {
+            subsetTextBounds(c.font, c.text, c.x, c.y, &w.x, &w.y, &w.w, &w.h);
+        } else if (c.text[0] != '\0') {
+            tft->setTextSize(1);
+            tft->getTextBounds(c.text, c.x, c.y, &w.x, &w.y, &w.w, &w.h);
+        }
+        unite(r, w.x, w.y, w.w, w.h);
+        if (r.w == 0 || full) continue;
         
-        tft->setCursor(4, 105);
-        tft->print("B:");
-        tft->setCursor(20, 105);
-        tft->print("--");
+        bool merged = false;
+        for (int j = 0; j < dirtyCount && !merged; j++) {
+            if (overlaps(dirty[j].x, dirty[j].y, dirty[j].w, dirty[j].h, r.x, r.y, r.w, r.h)) {
+                unite(dirty[j], r.x, r.y, r.w, r.h);
+                merged = true;
+            }
+        }
+        if (!merged) dirty[dirtyCount++] = r;
     }
     
-    // SECTION 2 (53-106): "A&E" sensor
-    tft->setTextColor(ST77XX_GREEN);
-    tft->setTextSize(1);
-    tft->setCursor(63, 73);
-    tft->print("A&E");
-    
-    if (hasAE) {
-        tft->setTextColor(ST77XX_WHITE);
-        tft->setCursor(58, 90);
-        tft->print("S:");
-        tft->setCursor(74, 90);
-        tft->printf("%d%%", aeData.soilMoisture);
-        
-        tft->setCursor(58, 105);
-        tft->print("B:");
-        tft->setCursor(74, 105);
-        tft->printf("%d%%", aeData.batteryPercent);
-    } else {
-        tft->setTextColor(ST77XX_WHITE);
-        tft->setCursor(58, 90);
-        tft->print("S:");
-        tft->setCursor(74, 90);
-        tft->print("--");
-        
-        tft->setCursor(58, 105);
-        tft->print("B:");
-        tft->setCursor(74, 105);
-        tft->print("--");
+    if (full) {
+        dirty[0] = { 0, 0, 160, 128 };
+        dirtyCount = 1;
     }
+    if (dirtyCount == 0) return false;
     
-    // SECTION 3 (106-160): Reserved for third sensor
-    tft->setTextColor(COLOR_GRAY);
-    tft->setTextSize(1);
-    tft->setCursor(118, 73);
-    tft->print("---");
-    tft->setCursor(112, 90);
-    tft->print("S:--");
-    tft->setCursor(112, 105);
-    tft->print("B:--");
+    for (int i = 0; i < dirtyCount; i++) flushRect(dirty[i], full);
     
-    Serial.println("Display updated: Trams, Weather, and Multi-Sensor Data");
+    renderStats.frames++;
+    renderStats.lastWidgets = changed;
+    renderStats.lastUs = micros() - start;
+    if (full) {
+        renderStats.fullFrames++;
+        renderStats.lastFullUs = renderStats.lastUs;
+    }
+    Serial.printf("Display updated: %s, %lu widgets in %lu us (last full board %lu us)\n",
+                 full ? "full board" : "changed widgets", (unsigned long)changed,
+                 (unsigned long)renderStats.lastUs,
+                 (unsigned long)renderStats.lastFullUs);
+    return true;
 }
 
 // ========== BRIGHTNESS CONTROL ==========
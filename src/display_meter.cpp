@@ -0,0 +1,44 @@
+#include "display_meter.h"
+
+// CASET + 4 argument bytes, RASET + 4, RAMWR
+#define WINDOW_OVERHEAD_BYTES 11
+
+void MeteredST7735::startWrite() {
+    cost.transactions++;
+    Adafruit_ST7735::startWrite();
+}
+
+void MeteredST7735::setAddrWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
+    uint32_t pixels = (uint32_t)w * h;
+    cost.windows++;
+    cost.pixels += pixels;
+    cost.bytes += WINDOW_OVERHEAD_BYTES + pixels * 2;
+    Adafruit_ST7735::setAddrWindow(x, y, w, h);
+}
+
+void MeteredST7735::sendCommand(uint8_t cmd, const uint8_t* data, uint8_t len) {
+    cost.transactions++;  // sendCommand opens its own
+    cost.commands++;
+    cost.bytes += 1 + len;
+    Adafruit_ST7735::sendCommand(cmd, data, len);
+}
+
+void MeteredST7735::beginCost() {
+    if (depth++ > 0) return;
+    cost = {};
+    startUs = micros();
+}
+
+void MeteredST7735::endCost(const char* name) {
+    if (depth == 0 || --depth > 0) return;
+    cost.us = micros() - startUs;
+    last = cost;
+    if (name) logCost(name, cost);
+}
+
+void MeteredST7735::logCost(const char* name, const DisplayCost& c) {
+    if (c.windows == 0 && c.commands == 0) return;
+    Serial.printf("%s: %lu px in %lu windows, %lu commands, %lu transactions, %lu SPI bytes, %lu us\n",
+                 name, (unsigned long)c.pixels, (unsigned long)c.windows, (unsigned long)c.commands,
+                 (unsigned long)c.transactions, (unsigned long)c.bytes, (unsigned long)c.us);
+}
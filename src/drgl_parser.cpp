@@ -0,0 +1,177 @@
+#include "drgl_parser.h"
+#include "swar_scan.h"
+#include <string.h>
+
+static inline bool isDigitChar(char c) {
+    return c >= '0' && c <= '9';
+}
+
+static inline bool isSpaceChar(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+void drglParserInit(DrglParser& p, DrglRecordCallback onRecord, void* ctx) {
+    memset(&p, 0, sizeof(p));
+    p.state = DRGL_SCAN_TIME;
+    p.onRecord = onRecord;
+    p.ctx = ctx;
+}
+
+void drglParserSetFilter(DrglParser& p, const char* line, const char* dest) {
+    p.lineFilter = line;
+    p.destFilter = dest;
+}
+
+// Hand the current record to the callback and go back to scanning
+static void emitRecord(DrglParser& p) {
+    bool keepGoing = true;
+    if (p.malformed) {
+        p.rejected++;
+    } else if (p.skipRecord) {
+        p.filtered++;
+    } else {
+        // Trim trailing whitespace (leading whitespace was skipped already)
+        while (p.destLen > 0 && isSpaceChar(p.rec.dest[p.destLen - 1])) p.destLen--;
+        p.rec.line[p.lineLen] = '\0';
+        p.rec.dest[p.destLen] = '\0';
+
+        if ((p.lineFilter != nullptr && strcmp(p.rec.line, p.lineFilter) != 0) ||
+            (p.destFilter != nullptr && strstr(p.rec.dest, p.destFilter) == nullptr)) {
+            p.filtered++;
+        } else {
+            keepGoing = p.onRecord(p.rec, p.ctx);
+        }
+    }
+    p.skipRecord = false;
+    p.malformed = false;
+    p.state = keepGoing ? DRGL_SCAN_TIME : DRGL_DONE;
+    p.inTag = false;
+    p.windowLen = 0;
+}
+
+// Slide one byte into the HH:MM window; returns true when it matches
+static bool pushTimeWindow(DrglParser& p, char c) {
+    if (p.windowLen == 5) {
+        memmove(p.window, p.window + 1, 4);
+        p.windowLen = 4;
+    }
+    p.window[p.windowLen++] = c;
+    if (p.windowLen < 5) return false;
+    return isDigitChar(p.window[0]) && isDigitChar(p.window[1]) && p.window[2] == ':' &&
+           isDigitChar(p.window[3]) && isDigitChar(p.window[4]);
+}
+
+// Start a new record at the HH:MM found at t
+static void beginRecord(DrglParser& p, const char* t) {
+    memcpy(p.rec.time, t, 5);
+    p.rec.time[5] = '\0';
+    p.lineLen = 0;
+    p.destLen = 0;
+    p.inTag = false;
+    p.skipRecord = false;
+    p.malformed = false;
+    p.windowLen = 0;
+    p.state = DRGL_SKIP_TO_LINE;
+}
+
+// Look for HH:MM from data[i]; returns the index just past what was consumed
+static size_t scanTime(DrglParser& p, const char* data, size_t len, size_t i) {
+    // A pattern may start in the bytes carried over from the previous chunk.
+    // Those are completed one byte at a time; four bytes settle every such case.
+    size_t start = i;
+    while (p.windowLen > 0 && i < len && i - start < 4) {
+        if (pushTimeWindow(p, data[i++])) {
+            beginRecord(p, p.window);
+            return i;
+        }
+    }
+    if (i == len) return len;  // Window still holds the tail
+
+    size_t span = len - start;
+    size_t found = swarFindTime(data + start, span);
+    if (found < span) {
+        beginRecord(p, data + start + found);
+        return start + found + 5;
+    }
+
+    // Carry the last four bytes: the start of a pattern split across chunks
+    size_t tail = span < 4 ? span : 4;
+    memcpy(p.window, data + len - tail, tail);
+    p.windowLen = tail;
+    return len;
+}
+
+bool drglParserFeed(DrglParser& p, const char* data, size_t len) {
+    size_t i = 0;
+    while (i < len) {
+        if (p.state == DRGL_DONE) return false;
+        char c = data[i];
+
+        switch (p.state) {
+            case DRGL_SCAN_TIME:
+                i = scanTime(p, data, len, i);
+                break;
+
+            case DRGL_SKIP_TO_LINE:
+            case DRGL_SKIP_TO_DEST:
+                if (p.inTag) {
+                    size_t end = i + swarFindByte(data + i, len - i, '>');
+                    if (end < len) p.inTag = false;
+                    i = end + (end < len ? 1 : 0);
+                } else if (c == '<') {
+                    p.inTag = true;
+                    i++;
+                } else if (isSpaceChar(c)) {
+                    i++;
+                } else {
+                    // Re-examine this byte in the next state
+                    p.state = (p.state == DRGL_SKIP_TO_LINE) ? DRGL_LINE : DRGL_DEST;
+                }
+                break;
+
+            case DRGL_LINE:
+                if (isDigitChar(c)) {
+                    // A longer number is not a line we know; cutting it
+                    // short could turn it into one that is
+                    if (p.lineLen < DRGL_MAX_LINE) {
+                        p.rec.line[p.lineLen++] = c;
+                    } else {
+                        p.malformed = true;
+                    }
+                    i++;
+                } else {
+                    // Decide on the line filter now so a dropped row's text is never copied
+                    p.rec.line[p.lineLen] = '\0';
+                    p.skipRecord = p.malformed ||
+                                   (p.lineFilter != nullptr && strcmp(p.rec.line, p.lineFilter) != 0);
+                    p.state = DRGL_SKIP_TO_DEST;
+                }
+                break;
+
+            case DRGL_DEST: {
+                // Copy up to the first '<' or line break, bounded by the field size
+                size_t room = DRGL_MAX_DEST - p.destLen;
+                size_t avail = (len - i < room) ? len - i : room;
+                size_t n = swarFindAny3(data + i, avail, '<', '\n', '\r');
+                if (!p.skipRecord) memcpy(p.rec.dest + p.destLen, data + i, n);
+                p.destLen += n;
+                i += n;
+                // The terminating byte is scanned again for the next time
+                if (i < len && (n < avail || p.destLen == DRGL_MAX_DEST)) {
+                    emitRecord(p);
+                }
+                break;
+            }
+
+            case DRGL_DONE:
+                return false;
+        }
+    }
+    return p.state != DRGL_DONE;
+}
+
+void drglParserFinish(DrglParser& p) {
+    if (p.state != DRGL_SCAN_TIME && p.state != DRGL_DONE) {
+        emitRecord(p);
+    }
+}
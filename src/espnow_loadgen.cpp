@@ -0,0 +1,112 @@
+#include "espnow_loadgen.h"
+#include "config.h"
+
+#if ESPNOW_LOADGEN
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "espnow_receiver.h"
+#include "sensor_wire.h"
+
+#define LOADGEN_TASK_STACK 4096
+#define LOADGEN_TASK_PRIORITY 5  // Above loop(), like the WiFi task it stands in for
+
+static const uint32_t loadRates[] = LOADGEN_RATES;
+
+// LOADGEN_MAC_PREFIX, so the receiver keeps these out of flash and history
+static void senderMac(uint16_t sender, uint8_t* mac) {
+    mac[0] = (LOADGEN_MAC_PREFIX >> 16) & 0xFF;
+    mac[1] = (LOADGEN_MAC_PREFIX >> 8) & 0xFF;
+    mac[2] = LOADGEN_MAC_PREFIX & 0xFF;
+    mac[3] = 0x00;
+    mac[4] = sender >> 8;
+    mac[5] = sender & 0xFF;
+}
+
+// One frame from one sender, with plausible and slowly changing values
+static size_t buildFrame(uint8_t* frame, uint16_t sender, uint16_t sequence) {
+    SensorWireReading readings[LOADGEN_READINGS];
+    for (int i = 0; i < LOADGEN_READINGS; i++) {
+        readings[i].batteryMv = 3600 + (sequence + sender) % 500;
+        readings[i].batteryPercent = 50 + (sequence + sender) % 50;
+        readings[i].moisturePermille = (sequence * 7 + sender * 13 + i) % 1000;
+        readings[i].ageSeconds = (LOADGEN_READINGS - 1 - i) * 60;
+    }
+    return sensorWireEncode(frame, SENSOR_WIRE_MAX_FRAME, sequence,
+                            sequence == 0 ? SENSOR_WIRE_FLAG_BOOT : 0, readings, LOADGEN_READINGS);
+}
+
+static void runRate(uint32_t rate, uint16_t* sequences) {
+    EspNowStats before = getEspNowStats();
+    resetEspNowPeaks();
+    uint32_t heapBefore = ESP.getFreeHeap();
+    
+    // Send what is due every tick, so the rate holds above the tick rate
+    uint8_t mac[6];
+    uint8_t frame[SENSOR_WIRE_MAX_FRAME];
+    uint32_t sent = 0;
+    unsigned long start = millis();
+    unsigned long elapsed;
+    while ((elapsed = millis() - start) < LOADGEN_SECONDS * 1000UL) {
+        uint32_t due = (uint64_t)rate * elapsed / 1000;
+        while (sent < due) {
+            uint16_t sender = sent % LOADGEN_SENDERS;
+            senderMac(sender, mac);
+            size_t len = buildFrame(frame, sender, sequences[sender]++);
+            onDataRecv(mac, frame, len);
+            sent++;
+        }
+        vTaskDelay(1);
+    }
+    
+    // Give the main loop a moment to drain the queue
+    vTaskDelay(pdMS_TO_TICKS(500));
+    EspNowStats after = getEspNowStats();
+    uint32_t processed = after.processed - before.processed;
+    uint32_t dropped = after.dropped - before.dropped;
+    uint32_t processUs = after.processUs - before.processUs;
+    int32_t heapGrowth = (int32_t)heapBefore - (int32_t)ESP.getFreeHeap();
+    
+    Serial.printf("Load %lu fps from %d senders: sent %lu, handled %lu (%lu/s), dropped %lu, max queue %lu\n",
+                 (unsigned long)rate, LOADGEN_SENDERS, (unsigned long)sent, (unsigned long)processed,
+                 (unsigned long)(processed * 1000UL / (LOADGEN_SECONDS * 1000UL + 500)),
+                 (unsigned long)dropped, (unsigned long)after.maxQueueDepth);
+    Serial.printf("  callback p50 <%lu us, p99 <%lu us, max %lu us; main loop %lu us/frame; heap %+ld bytes\n",
+                 (unsigned long)after.callbackP50Us, (unsigned long)after.callbackP99Us,
+                 (unsigned long)after.callbackMaxUs,
+                 (unsigned long)(processed > 0 ? processUs / processed : 0), (long)heapGrowth);
+}
+
+static void loadGenTask(void* arg) {
+    // Let setup() finish before loading the receiver
+    vTaskDelay(pdMS_TO_TICKS(LOADGEN_START_DELAY));
+    Serial.println("=== ESP-NOW load test ===");
+    
+    // This task stands in for the radio: real frames would make a second
+    // producer on the receiver's single-producer queue
+    detachEspNowRadio();
+    static uint16_t sequences[LOADGEN_SENDERS];
+    for (uint32_t rate : loadRates) {
+        runRate(rate, sequences);
+    }
+    attachEspNowRadio();
+    
+    EspNowStats stats = getEspNowStats();
+    Serial.printf("=== Load test done: %lu sensors in table, %lu refused, %lu duplicates, min free heap %lu ===\n",
+                 (unsigned long)stats.sensors, (unsigned long)stats.sensorsRefused,
+                 (unsigned long)stats.duplicates, (unsigned long)ESP.getMinFreeHeap());
+    // The made-up senders would otherwise hold table slots and board cells
+    evictSyntheticSensors();
+    vTaskDelete(nullptr);
+}
+
+void startEspNowLoadGen() {
+    xTaskCreate(loadGenTask, "loadgen", LOADGEN_TASK_STACK, nullptr, LOADGEN_TASK_PRIORITY, nullptr);
+    Serial.println("ESP-NOW load generator started");
+}
+
+#else
+
+void startEspNowLoadGen() {}
+
+#endif
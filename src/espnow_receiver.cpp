@@ -1,11 +1,184 @@
 #include "espnow_receiver.h"
+#include "config.h"
+#include "spsc_ring.h"
+#include "sensor_history.h"
+#include "sensor_wire.h"
 #include <esp_now.h>
+#include <Preferences.h>
 #include <WiFi.h>
-#include <map>
+#include <atomic>
 
-// Storage for multiple sensors - key is MAC address as uint64_t
-static std::map<uint64_t, sensor_data_t> sensorDataMap;
-static std::map<uint64_t, unsigned long> lastReceivedTimeMap;
+// Every sensor ever heard, in one flat open-addressing table keyed by
+// MAC. Only the main loop touches it; the radio callback goes through the ring.
+static SensorState sensorTable[SENSOR_TABLE_SIZE];  // mac == 0: free slot
+static uint32_t sensorCount = 0;
+static SensorState* registry[SENSOR_TABLE_SIZE];  // Occupied slots in registration order
+static uint32_t sensorsRefused = 0;  // New sensors turned away, table full
+static uint32_t framesDuplicate = 0;
+static uint32_t framesReordered = 0;
+static uint32_t framesResynced = 0;
+
+// Fibonacci hashing spreads MACs from one vendor prefix over the table
+static uint32_t sensorBucket(uint64_t mac) {
+  return (uint32_t)((mac * 0x9E3779B97F4A7C15ull) >> 32) & (SENSOR_TABLE_SIZE - 1);
+}
+
+// Linear probing; the table is never filled past 3/4, so chains stay short
+static SensorState* findSlot(uint64_t mac, bool insert) {
+  uint32_t b = sensorBucket(mac);
+  while (sensorTable[b].mac != 0) {
+    if (sensorTable[b].mac == mac) return &sensorTable[b];
+    b = (b + 1) & (SENSOR_TABLE_SIZE - 1);
+  }
+  if (!insert) return nullptr;
+  if (sensorCount >= SENSOR_TABLE_SIZE * 3 / 4) {
+    sensorsRefused++;
+    return nullptr;
+  }
+  registry[sensorCount++] = &sensorTable[b];
+  sensorTable[b].mac = mac;
+  return &sensorTable[b];
+}
+
+// Empty slot b. Later entries of the same probe chain move back into the
+// hole, so lookups never stop short and no tombstones are needed.
+static void removeSlot(uint32_t b) {
+  memset(&sensorTable[b], 0, sizeof(SensorState));
+  for (uint32_t j = (b + 1) & (SENSOR_TABLE_SIZE - 1); sensorTable[j].mac != 0;
+       j = (j + 1) & (SENSOR_TABLE_SIZE - 1)) {
+    // The entry at j may fill the hole only if that is not before its home bucket
+    uint32_t home = sensorBucket(sensorTable[j].mac);
+    if (((j - home) & (SENSOR_TABLE_SIZE - 1)) < ((j - b) & (SENSOR_TABLE_SIZE - 1))) continue;
+    sensorTable[b] = sensorTable[j];
+    for (uint32_t i = 0; i < sensorCount; i++) {
+      if (registry[i] == &sensorTable[j]) registry[i] = &sensorTable[b];
+    }
+    memset(&sensorTable[j], 0, sizeof(SensorState));
+    b = j;
+  }
+}
+
+// ===== Registry =====
+// Sensors register themselves with their first packet. The MACs and names
+// are kept in flash so the panel shows them in the same order after a reboot.
+
+struct RegistryEntry {
+  uint64_t mac;
+  char name[SENSOR_NAME_LEN];
+};
+
+struct DefaultSensorName {
+  uint64_t mac;
+  const char* name;
+};
+
+static const DefaultSensorName defaultNames[] = SENSOR_NAMES;
+
+#if ESPNOW_LOADGEN
+// The load generator's made-up senders, see senderMac() in espnow_loadgen.cpp
+static bool isSyntheticMac(uint64_t mac) {
+  return (mac >> 24) == LOADGEN_MAC_PREFIX;
+}
+#else
+static bool isSyntheticMac(uint64_t) {
+  return false;
+}
+#endif
+
+static void saveRegistry() {
+  static RegistryEntry entries[SENSOR_TABLE_SIZE];
+  uint32_t count = 0;
+  for (uint32_t i = 0; i < sensorCount; i++) {
+    if (isSyntheticMac(registry[i]->mac)) continue;
+    entries[count].mac = registry[i]->mac;
+    memcpy(entries[count].name, registry[i]->name, SENSOR_NAME_LEN);
+    count++;
+  }
+  Preferences prefs;
+  if (!prefs.begin("sensors", false)) return;
+  size_t len = count * sizeof(RegistryEntry);
+  if (prefs.putBytes("registry", entries, len) != len) {
+    Serial.println("ERROR: Failed to save sensor registry");
+  }
+  prefs.end();
+}
+
+static void loadRegistry() {
+  static RegistryEntry entries[SENSOR_TABLE_SIZE];
+  size_t len = 0;
+  Preferences prefs;
+  if (prefs.begin("sensors", true)) {
+    len = prefs.getBytesLength("registry");
+    if (len % sizeof(RegistryEntry) != 0 || len > sizeof(entries)) len = 0;
+    if (len > 0) len = prefs.getBytes("registry", entries, len);
+    prefs.end();
+  }
+  for (size_t i = 0; i < len / sizeof(RegistryEntry); i++) {
+    SensorState* sensor = findSlot(entries[i].mac, true);
+    if (sensor == nullptr) break;
+    strlcpy(sensor->name, entries[i].name, SENSOR_NAME_LEN);
+  }
+  // Sensors named in config.h get their cells even before they report
+  for (const DefaultSensorName& d : defaultNames) {
+    SensorState* sensor = findSlot(d.mac, true);
+    if (sensor != nullptr && sensor->name[0] == '\0') strlcpy(sensor->name, d.name, SENSOR_NAME_LEN);
+  }
+  Serial.printf("Sensor registry: %lu known sensors\n", (unsigned long)sensorCount);
+}
+
+// First packet from a sensor nobody named: call it after its MAC
+static void registerSensor(SensorState* sensor) {
+  if (sensor->name[0] != '\0') return;
+  snprintf(sensor->name, SENSOR_NAME_LEN, "S-%04X", (unsigned)(sensor->mac & 0xFFFF));
+  if (isSyntheticMac(sensor->mac)) return;
+  Serial.printf("New sensor registered as %s\n", sensor->name);
+  saveRegistry();
+}
+
+// Forget every made-up sender, keeping the registration order of the rest
+static void removeSyntheticSensors() {
+  uint32_t removed = 0;
+  for (uint32_t i = 0; i < sensorCount;) {
+    SensorState* sensor = registry[i];
+    if (!isSyntheticMac(sensor->mac)) {
+      i++;
+      continue;
+    }
+    memmove(&registry[i], &registry[i + 1], (sensorCount - i - 1) * sizeof(registry[0]));
+    sensorCount--;
+    removeSlot(sensor - sensorTable);
+    removed++;
+  }
+  Serial.printf("Removed %lu synthetic sensors, %lu left\n", (unsigned long)removed, (unsigned long)sensorCount);
+}
+
+// A frame as the radio callback saw it, decoded later by the main loop
+struct SensorPacket {
+  uint64_t mac;
+  unsigned long receivedAt;
+  uint8_t len;
+  uint8_t frame[SENSOR_WIRE_MAX_FRAME];  // sensor_wire.h format, or a raw sensor_data_t
+};
+
+static SpscRing<SensorPacket, ESPNOW_QUEUE_SIZE> packetRing;
+
+// Written by the callback only, read by the main loop
+static std::atomic<uint32_t> packetsReceived{0};
+static std::atomic<uint32_t> packetsDropped{0};
+static std::atomic<uint32_t> packetsRejected{0};
+static std::atomic<uint32_t> maxQueueDepth{0};
+
+// Callback duration in 1 us steps; the last bucket takes everything longer
+#define LATENCY_BUCKETS 64
+static std::atomic<uint32_t> callbackLatency[LATENCY_BUCKETS];
+static std::atomic<uint32_t> callbackMaxUs{0};
+
+// Set from any task, acted on by the main loop
+static std::atomic<bool> evictSynthetic{false};
+
+// Main loop only
+static uint32_t framesProcessed = 0;
+static uint32_t processUs = 0;
 
 // Convert MAC array to uint64_t for use as map key
 uint64_t macToUint64(const uint8_t* mac) {
@@ -18,28 +191,128 @@ uint64_t macToUint64(const uint8_t* mac) {
 
 // Get sensor name from MAC
 const char* getSensorName(uint64_t macAddress) {
-  if (macAddress == OLGA_MAC) return "Olga";
-  if (macAddress == AE_MAC) return "A&E";
-  return "Unknown";
+  const SensorState* sensor = findSlot(macAddress, false);
+  return sensor != nullptr && sensor->name[0] != '\0' ? sensor->name : "Unknown";
+}
+
+// Validate a frame and copy it into the ring for the main loop
+static void queueFrame(const uint8_t *mac_addr, const uint8_t *data, int data_len) {
+  SensorWireHeader header;
+  if (data_len != sizeof(sensor_data_t) &&
+      (data_len > SENSOR_WIRE_MAX_FRAME || !sensorWireParseHeader(data, data_len, header))) {
+    packetsRejected.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  
+  SensorPacket packet;
+  packet.mac = macToUint64(mac_addr);
+  packet.receivedAt = millis();
+  packet.len = data_len;
+  memcpy(packet.frame, data, data_len);
+  
+  if (!packetRing.push(packet)) {
+    packetsDropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  packetsReceived.fetch_add(1, std::memory_order_relaxed);
+  
+  uint32_t depth = packetRing.depth();
+  if (depth > maxQueueDepth.load(std::memory_order_relaxed)) {
+    maxQueueDepth.store(depth, std::memory_order_relaxed);
+  }
 }
 
-// Callback when ESP-NOW data is received
+// Callback when ESP-NOW data is received. Runs in the WiFi task: it only
+// copies the packet into the ring, no allocation and no logging.
 void onDataRecv(const uint8_t *mac_addr, const uint8_t *data, int data_len) {
-  if (data_len == sizeof(sensor_data_t)) {
-    uint64_t macKey = macToUint64(mac_addr);
-    sensor_data_t receivedData;
-    memcpy(&receivedData, data, sizeof(sensor_data_t));
+  unsigned long start = micros();
+  queueFrame(mac_addr, data, data_len);
+  
+  uint32_t us = micros() - start;
+  callbackLatency[us < LATENCY_BUCKETS ? us : LATENCY_BUCKETS - 1].fetch_add(1, std::memory_order_relaxed);
+  if (us > callbackMaxUs.load(std::memory_order_relaxed)) {
+    callbackMaxUs.store(us, std::memory_order_relaxed);
+  }
+}
+
+// Drop frames already seen or overtaken by a newer one. A sensor that
+// rebooted says so, otherwise its restarted sequence would look old. If
+// that frame was lost, a sequence far behind or a frame after a long
+// silence is taken as a restart: it is applied and becomes the new base.
+static bool acceptSequence(SensorState* sensor, const SensorWireHeader& header, unsigned long receivedAt) {
+  if (sensor->hasSequence && !(header.flags & SENSOR_WIRE_FLAG_BOOT)) {
+    int16_t ahead = (int16_t)(header.sequence - sensor->lastSequence);
+    bool silent = receivedAt - sensor->lastSeen > SENSOR_RESYNC_SILENCE_MS;
+    if (ahead <= 0 && (silent || ahead < -SENSOR_RESYNC_GAP)) {
+      framesResynced++;
+    } else if (ahead == 0) {
+      framesDuplicate++;
+      return false;
+    } else if (ahead < 0) {
+      framesReordered++;
+      return false;
+    }
+  }
+  sensor->hasSequence = true;
+  sensor->lastSequence = header.sequence;
+  return true;
+}
+
+// Apply one reading taken `age` seconds before the frame arrived
+static void applyReading(SensorState* sensor, const SensorPacket& packet, const sensor_data_t& data, uint32_t age) {
+  sensor->data = data;
+  sensor->lastSeen = packet.receivedAt;
+  if (isSyntheticMac(packet.mac)) return;
+  time_t now = time(nullptr);
+  recordSensorHistory(packet.mac, data, now - (time_t)age);
+}
+
+void processSensorPackets() {
+  SensorPacket packet;
+  // Frames still queued from a load run go first, or they would come back
+  bool evict = evictSynthetic.exchange(false, std::memory_order_acquire);
+  while (packetRing.pop(packet)) {
+    unsigned long start = micros();
+    framesProcessed++;
+    SensorState* sensor = findSlot(packet.mac, true);
+    if (sensor == nullptr) continue;
+    registerSensor(sensor);
     
-    // Store data in map
-    sensorDataMap[macKey] = receivedData;
-    lastReceivedTimeMap[macKey] = millis();
+    uint8_t readings = 1;
+    if (packet.len == sizeof(sensor_data_t)) {
+      // Old sensor firmware: the struct as laid out by its compiler
+      sensor_data_t data;
+      memcpy(&data, packet.frame, sizeof(data));
+      applyReading(sensor, packet, data, 0);
+    } else {
+      SensorWireHeader header;
+      sensorWireParseHeader(packet.frame, packet.len, header);
+      if (!acceptSequence(sensor, header, packet.receivedAt)) continue;
+      readings = header.count;
+      for (uint8_t i = 0; i < header.count; i++) {
+        SensorWireReading r = sensorWireReading(packet.frame, i);
+        sensor_data_t data;
+        data.batteryVoltage = r.batteryMv / 1000.0f;
+        data.batteryPercent = r.batteryPercent;
+        data.soilMoisture = (r.moisturePermille + 5) / 10;
+        data.timestamp = packet.receivedAt - r.ageSeconds * 1000UL;
+        applyReading(sensor, packet, data, r.ageSeconds);
+      }
+    }
+    sensor->packets++;
+    processUs += micros() - start;
+    if (isSyntheticMac(packet.mac)) continue;
     
-    const char* sensorName = getSensorName(macKey);
+    const sensor_data_t& receivedData = sensor->data;
+    const char* sensorName = getSensorName(packet.mac);
     
     Serial.println("\n=== ESP-NOW Data Received ===");
     Serial.printf("From: %02X:%02X:%02X:%02X:%02X:%02X (%s)\n",
-                  mac_addr[0], mac_addr[1], mac_addr[2],
-                  mac_addr[3], mac_addr[4], mac_addr[5], sensorName);
+                  (uint8_t)(packet.mac >> 40), (uint8_t)(packet.mac >> 32), (uint8_t)(packet.mac >> 24),
+                  (uint8_t)(packet.mac >> 16), (uint8_t)(packet.mac >> 8), (uint8_t)packet.mac, sensorName);
+    if (sensor->hasSequence) {
+      Serial.printf("Frame #%u with %u reading(s)\n", sensor->lastSequence, readings);
+    }
     Serial.printf("Battery: %.2fV (%d%%)\n", 
                   receivedData.batteryVoltage,
                   receivedData.batteryPercent);
@@ -47,13 +320,74 @@ void onDataRecv(const uint8_t *mac_addr, const uint8_t *data, int data_len) {
     Serial.printf("Timestamp: %lu ms\n", receivedData.timestamp);
     Serial.println("============================\n");
   }
+  if (evict) removeSyntheticSensors();
+}
+
+void evictSyntheticSensors() {
+  evictSynthetic.store(true, std::memory_order_release);
+}
+
+void resetEspNowPeaks() {
+  for (int i = 0; i < LATENCY_BUCKETS; i++) callbackLatency[i].store(0, std::memory_order_relaxed);
+  callbackMaxUs.store(0, std::memory_order_relaxed);
+  maxQueueDepth.store(0, std::memory_order_relaxed);
+}
+
+// The WiFi task runs above every other task on this single core, so once
+// the callback is unregistered none of its calls can still be in progress
+void detachEspNowRadio() {
+  esp_now_unregister_recv_cb();
+}
+
+void attachEspNowRadio() {
+  esp_now_register_recv_cb(onDataRecv);
+}
+
+EspNowStats getEspNowStats() {
+  EspNowStats stats;
+  stats.received = packetsReceived.load(std::memory_order_relaxed);
+  stats.dropped = packetsDropped.load(std::memory_order_relaxed);
+  stats.rejected = packetsRejected.load(std::memory_order_relaxed);
+  stats.maxQueueDepth = maxQueueDepth.load(std::memory_order_relaxed);
+  stats.sensors = sensorCount;
+  stats.sensorsRefused = sensorsRefused;
+  stats.duplicates = framesDuplicate;
+  stats.reordered = framesReordered;
+  stats.resynced = framesResynced;
+  stats.processed = framesProcessed;
+  stats.processUs = processUs;
+  
+  // Percentiles from the callback histogram, as the bucket's upper bound
+  uint32_t counts[LATENCY_BUCKETS];
+  uint32_t total = 0;
+  for (int i = 0; i < LATENCY_BUCKETS; i++) {
+    counts[i] = callbackLatency[i].load(std::memory_order_relaxed);
+    total += counts[i];
+  }
+  uint32_t seen = 0;
+  stats.callbackP50Us = stats.callbackP99Us = 0;
+  for (int i = 0; i < LATENCY_BUCKETS && total > 0; i++) {
+    seen += counts[i];
+    if (stats.callbackP50Us == 0 && seen * 2 >= total) stats.callbackP50Us = i + 1;
+    if (seen * 100 >= total * 99) {
+      stats.callbackP99Us = i + 1;
+      break;
+    }
+  }
+  stats.callbackMaxUs = callbackMaxUs.load(std::memory_order_relaxed);
+  return stats;
 }
 
 void initESPNowReceiver() {
   Serial.println("Initializing ESP-NOW receiver...");
+  loadRegistry();
   Serial.println("Waiting for sensors:");
-  Serial.println("  - Olga (MAC: 80:F1:B2:50:29:74)");
-  Serial.println("  - A&E  (MAC: 80:F1:B2:50:29:48)");
+  for (uint32_t i = 0; i < sensorCount; i++) {
+    uint64_t mac = registry[i]->mac;
+    Serial.printf("  - %s (MAC: %02X:%02X:%02X:%02X:%02X:%02X)\n", registry[i]->name,
+                  (uint8_t)(mac >> 40), (uint8_t)(mac >> 32), (uint8_t)(mac >> 24),
+                  (uint8_t)(mac >> 16), (uint8_t)(mac >> 8), (uint8_t)mac);
+  }
   
   // ESP-NOW must be initialized after WiFi is set up
   if (esp_now_init() != ESP_OK) {
@@ -64,20 +398,42 @@ void initESPNowReceiver() {
   Serial.println("ESP-NOW initialized successfully");
   
   // Register receive callback
-  esp_now_register_recv_cb(onDataRecv);
+  attachEspNowRadio();
   
   Serial.println("ESP-NOW receiver ready, waiting for sensor data...");
 }
 
+const SensorState* findSensor(uint64_t macAddress) {
+  const SensorState* sensor = findSlot(macAddress, false);
+  return sensor != nullptr && sensor->packets > 0 ? sensor : nullptr;
+}
+
+uint32_t sensorCountRegistered() {
+  return sensorCount;
+}
+
+const SensorState* sensorAt(uint32_t index) {
+  return index < sensorCount ? registry[index] : nullptr;
+}
+
+bool setSensorName(uint64_t macAddress, const char* name) {
+  SensorState* sensor = findSlot(macAddress, true);
+  if (sensor == nullptr) return false;
+  strlcpy(sensor->name, name, SENSOR_NAME_LEN);
+  saveRegistry();
+  return true;
+}
+
 // Check if specific sensor has data
 bool hasSensorData(uint64_t macAddress) {
-  return sensorDataMap.find(macAddress) != sensorDataMap.end();
+  return findSensor(macAddress) != nullptr;
 }
 
 // Get data from specific sensor
 sensor_data_t getSensorData(uint64_t macAddress) {
-  if (hasSensorData(macAddress)) {
-    return sensorDataMap[macAddress];
+  const SensorState* sensor = findSensor(macAddress);
+  if (sensor != nullptr) {
+    return sensor->data;
   }
   // Return empty data if not found
   return {0, 0, 0, 0};
@@ -85,23 +441,25 @@ sensor_data_t getSensorData(uint64_t macAddress) {
 
 // Get last received time for specific sensor
 unsigned long getLastReceivedTime(uint64_t macAddress) {
-  if (lastReceivedTimeMap.find(macAddress) != lastReceivedTimeMap.end()) {
-    return lastReceivedTimeMap[macAddress];
-  }
-  return 0;
+  const SensorState* sensor = findSensor(macAddress);
+  return sensor != nullptr ? sensor->lastSeen : 0;
+}
+
+// Legacy functions for backward compatibility (use the first registered sensor)
+static uint64_t firstSensorMac() {
+  return sensorCount > 0 ? registry[0]->mac : 0;
 }
 
-// Legacy functions for backward compatibility (use Olga data)
 bool hasSensorData() {
-  return hasSensorData(OLGA_MAC);
+  return hasSensorData(firstSensorMac());
 }
 
 sensor_data_t getLatestSensorData() {
-  return getSensorData(OLGA_MAC);
+  return getSensorData(firstSensorMac());
 }
 
 unsigned long getLastReceivedTime() {
-  return getLastReceivedTime(OLGA_MAC);
+  return getLastReceivedTime(firstSensorMac());
 }
 
 void printSensorData(const sensor_data_t& data, const uint8_t* mac) {
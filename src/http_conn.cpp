@@ -0,0 +1,222 @@
+#include "http_conn.h"
+#include "config.h"
+
+static const char* const hostNames[HOST_COUNT] = {
+    "drgl.nl",
+    "api.open-meteo.com"
+};
+
+static WiFiClientSecure clients[HOST_COUNT];
+static HTTPClient https[HOST_COUNT];
+static HttpConnStats stats[HOST_COUNT];
+static bool initialized[HOST_COUNT] = {false};
+
+static const char* responseHeaders[] = { "Transfer-Encoding", "ETag", "Last-Modified" };
+
+static void initHost(HttpHost host) {
+    if (initialized[host]) return;
+    initialized[host] = true;
+
+    // No CA pinning, same as the plain HTTPClient::begin(url) used before
+    clients[host].setInsecure();
+    clients[host].setHandshakeTimeout(HTTP_TIMEOUT_MS / 1000);
+
+    HTTPClient& http = https[host];
+    http.setReuse(true);
+    http.setTimeout(HTTP_TIMEOUT_MS);
+    http.setConnectTimeout(HTTP_TIMEOUT_MS);
+    http.setFollowRedirects(HTTPC_STRICT_FOLLOW_REDIRECTS);
+    http.collectHeaders(responseHeaders, sizeof(responseHeaders) / sizeof(responseHeaders[0]));
+}
+
+int httpGet(HttpHost host, const char* url, HttpBody& body, HttpValidators* validators) {
+    initHost(host);
+    HTTPClient& http = https[host];
+    WiFiClientSecure& client = clients[host];
+    HttpConnStats& s = stats[host];
+
+    body.host = host;
+    body.stream = nullptr;
+    body.chunked = false;
+    body.done = true;
+    body.failed = true;
+    body.remaining = 0;
+
+    int code = HTTPC_ERROR_CONNECTION_REFUSED;
+    for (int attempt = 0; attempt < 2; attempt++) {
+        // Open the socket ourselves so the handshake can be timed separately
+        bool reusing = client.connected();
+        if (reusing) {
+            s.reused++;
+        } else {
+            unsigned long start = millis();
+            if (!client.connect(hostNames[host], 443)) {
+                Serial.printf("ERROR: TLS connect to %s failed\n", hostNames[host]);
+                return HTTPC_ERROR_CONNECTION_REFUSED;
+            }
+            s.handshakes++;
+            s.lastConnectMs = millis() - start;
+            Serial.printf("TLS handshake with %s took %lu ms (#%lu)\n",
+                         hostNames[host], (unsigned long)s.lastConnectMs, (unsigned long)s.handshakes);
+        }
+
+        if (!http.begin(client, url)) {
+            Serial.println("ERROR: Failed to begin HTTP connection");
+            return HTTPC_ERROR_CONNECTION_REFUSED;
+        }
+
+        // Set user agent to avoid blocking
+        http.setUserAgent("Mozilla/5.0 (ESP32)");
+        if (validators != nullptr) {
+            if (validators->etag[0]) http.addHeader("If-None-Match", validators->etag);
+            if (validators->lastModified[0]) http.addHeader("If-Modified-Since", validators->lastModified);
+        }
+
+        unsigned long start = millis();
+        code = http.GET();
+        s.requests++;
+        s.lastRequestMs = millis() - start;
+
+        if (code > 0) break;
+        client.stop();
+        // The server may have dropped an idle socket; retry once on a new one
+        if (!reusing) return code;
+        Serial.printf("Kept-alive socket to %s was stale, reconnecting\n", hostNames[host]);
+    }
+
+    if (code <= 0) return code;
+
+    if (validators != nullptr && code == HTTP_CODE_OK) {
+        strlcpy(validators->etag, http.header("ETag").c_str(), sizeof(validators->etag));
+        strlcpy(validators->lastModified, http.header("Last-Modified").c_str(), sizeof(validators->lastModified));
+    }
+
+    body.stream = http.getStreamPtr();
+    body.chunked = http.header("Transfer-Encoding").equalsIgnoreCase("chunked");
+    body.remaining = body.chunked ? 0 : http.getSize();
+    body.failed = false;
+    // No body follows these
+    body.done = (code == HTTP_CODE_NO_CONTENT || code == HTTP_CODE_NOT_MODIFIED ||
+                 (!body.chunked && body.remaining == 0));
+    return code;
+}
+
+// Wait until at least one byte is buffered; false on timeout or close
+static bool waitForData(HttpBody& body) {
+    unsigned long start = millis();
+    while (body.stream->available() == 0) {
+        if (!body.stream->connected()) return false;
+        if (millis() - start >= HTTP_TIMEOUT_MS) return false;
+        delay(1);
+    }
+    return true;
+}
+
+static int readByte(HttpBody& body) {
+    if (!waitForData(body)) return -1;
+    return body.stream->read();
+}
+
+// Parse "<hex>[;ext]\r\n" ahead of each chunk
+static bool readChunkHeader(HttpBody& body) {
+    int32_t size = 0;
+    bool inExtension = false;
+    int c;
+    while ((c = readByte(body)) >= 0 && c != '\n') {
+        if (c == ';') inExtension = true;
+        if (inExtension || c == '\r') continue;
+        int digit = isdigit(c) ? c - '0' : (tolower(c) >= 'a' && tolower(c) <= 'f') ? tolower(c) - 'a' + 10 : -1;
+        if (digit < 0) return false;
+        size = (size << 4) | digit;
+    }
+    if (c < 0) return false;
+
+    if (size == 0) {
+        // Last chunk: skip optional trailers up to the empty line
+        int lineLen = 0;
+        while ((c = readByte(body)) >= 0) {
+            if (c == '\n') {
+                if (lineLen == 0) break;
+                lineLen = 0;
+            } else if (c != '\r') {
+                lineLen++;
+            }
+        }
+        if (c < 0) return false;
+        body.done = true;
+    }
+    body.remaining = size;
+    return true;
+}
+
+int httpRead(HttpBody& body, char* buf, size_t len) {
+    if (body.failed) return -1;
+    if (body.done) return 0;
+
+    if (body.chunked && body.remaining == 0) {
+        if (!readChunkHeader(body)) {
+            body.failed = true;
+            return -1;
+        }
+        if (body.done) return 0;
+    }
+
+    if (!waitForData(body)) {
+        // A body without length ends when the server closes the socket
+        if (!body.chunked && body.remaining < 0 && !body.stream->connected()) {
+            body.done = true;
+            return 0;
+        }
+        body.failed = true;
+        return -1;
+    }
+
+    size_t want = len;
+    if (body.remaining >= 0 && (size_t)body.remaining < want) want = body.remaining;
+    size_t avail = body.stream->available();
+    if (avail < want) want = avail;
+
+    int n = body.stream->read((uint8_t*)buf, want);
+    if (n <= 0) {
+        body.failed = true;
+        return -1;
+    }
+
+    if (body.remaining > 0) body.remaining -= n;
+    if (body.remaining == 0) {
+        if (body.chunked) {
+            // CRLF after the chunk data
+            if (readByte(body) != '\r' || readByte(body) != '\n') body.failed = true;
+        } else {
+            body.done = true;
+        }
+    }
+    return n;
+}
+
+void httpFinish(HttpBody& body, bool keepAlive) {
+    HttpHost host = body.host;
+
+    // Only a body with known framing can be skipped to its end
+    if (keepAlive && !body.done && !body.failed && (body.chunked || body.remaining >= 0)) {
+        static char scratch[FETCH_CHUNK_SIZE];
+        unsigned long start = millis();
+        size_t drained = 0;
+        while (!body.done && !body.failed && drained < HTTP_DRAIN_LIMIT &&
+               millis() - start < HTTP_TIMEOUT_MS) {
+            int n = httpRead(body, scratch, sizeof(scratch));
+            if (n < 0) break;
+            drained += n;
+        }
+    }
+
+    if (!keepAlive || !body.done || body.failed) {
+        clients[host].stop();
+    }
+    // Keeps the socket open when the server allows reuse
+    https[host].end();
+}
+
+const HttpConnStats& getHttpConnStats(HttpHost host) {
+    return stats[host];
+}
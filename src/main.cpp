@@ -5,45 +5,207 @@
 #include "config.h"
 #include "espnow_receiver.h"
 #include "weather.h"
+#include "poll_sched.h"
+#include "net_task.h"
+#include "snapshot.h"
+#include "sensor_history.h"
+#include "espnow_loadgen.h"
+#include "clock_keeper.h"
+#include "str_pool.h"
 #include <time.h>
 
 #define LED_PIN 8  // Onboard LED on ESP32-C3
 
 unsigned long lastUpdate = 0;
+unsigned long nextFetchDelay = 0;  // Chosen by the poll scheduler after each fetch
 unsigned long lastWeatherUpdate = 0;
 unsigned long lastBrightnessUpdate = 0;
+unsigned long lastRender = 0;
+uint8_t jobsInFlight = 0;          // NetJob bits requested but not yet answered
+uint32_t maxLoopStallMs = 0;       // Longest loop() pass, excluding the idle delay
 Weather currentWeather;
+DepartureTable trams;  // Reused every cycle, filled in place by fetchTrams()
+bool showingSnapshot = false;    // Board restored from flash is on screen
+unsigned long firstFrameMs = 0;  // millis() when the first board (any data) was drawn
+unsigned long firstLiveFrameMs = 0;  // millis() when the first fetched board was drawn
 
-void syncTime() {
-    Serial.println("Syncing time with NTP...");
-    // CET = UTC+1 (3600 seconds), DST offset = 3600 for summer (but not active in December)
-    // For Netherlands: use 3600 offset, 0 DST in winter, 3600 DST in summer
-    configTime(3600, 0, "pool.ntp.org", "time.nist.gov");  // CET timezone (UTC+1, no DST in December)
-    
-    Serial.print("Waiting for NTP time sync");
-    int attempts = 0;
-    while (time(nullptr) < 100000 && attempts < 30) {
-        Serial.print(".");
-        delay(500);
-        attempts++;
-    }
-    Serial.println();
-    
-    time_t now = time(nullptr);
-    if (now > 100000) {
-        struct tm* ti = localtime(&now);
-        Serial.printf("Time synced: %04d-%02d-%02d %02d:%02d:%02d (CET)\n", 
-                     ti->tm_year + 1900, ti->tm_mon + 1, ti->tm_mday,
-                     ti->tm_hour, ti->tm_min, ti->tm_sec);
+// How many fetch cycles could stop early at each stage
+struct CycleStats {
+    uint32_t cycles;
+    uint32_t networkSkipped;  // Server answered 304, nothing downloaded
+    uint32_t parseSkipped;    // Departures unchanged, table kept
+    uint32_t renderSkipped;   // Nothing visible changed, no redraw
+};
+CycleStats cycleStats;
+
+// Draw the board from the current table and clock. Returns false when
+// nothing visible changed. verbose logs the data sources (once per fetch).
+bool renderBoard(bool verbose) {
+    pruneDeparted(trams, time(nullptr));
+    
+    if (trams.empty()) {
+        // Only replace the screen after a fetch, not on every tick
+        if (verbose) {
+            Serial.println("ERROR: No trams returned from API");
+            showDebugInfo("No data", getLastHttpCode(), getLastHtmlSize(), getLastFoundEntries());
+        }
+        return verbose;
+    }
+    
+    if (verbose) Serial.printf("SUCCESS: Got %u trams, displaying now\n", (unsigned)trams.size());
+    
+#if BOARD_LAYOUT_LIST
+    // Every departure on scrolling cards; no weather or sensor sections
+    return showTrams(trams);
+#else
+    // Check what data we have available
+    bool hasWeather = currentWeather.valid;
+    
+    // Sensors are shown BOARD_SENSOR_CELLS at a time, paging through the registry
+    uint32_t sensorTotal = sensorCountRegistered();
+    uint8_t pages = sensorTotal == 0 ? 1 : (sensorTotal + BOARD_SENSOR_CELLS - 1) / BOARD_SENSOR_CELLS;
+    uint8_t page = (millis() / SENSOR_PAGE_MS) % pages;
+    
+    // Get sensor data with age check (7 hours - sensors wake every 6 hours)
+    // Keep displaying data until next expected reading
+    const unsigned long MAX_DATA_AGE = 7UL * 60UL * 60UL * 1000UL; // 7 hours in milliseconds
+    
+    SensorCell cells[BOARD_SENSOR_CELLS] = {};
+    for (int i = 0; i < BOARD_SENSOR_CELLS; i++) {
+        const SensorState* sensor = sensorAt(page * BOARD_SENSOR_CELLS + i);
+        if (sensor == nullptr) continue;
+        cells[i].name = sensor->name;
+        cells[i].trendPoints = sensorSparkline(sensor->mac, HISTORY_MOISTURE, BOARD_TREND_POINTS * 3600UL,
+                                               time(nullptr), cells[i].trend, BOARD_TREND_POINTS);
+        if (sensor->packets == 0) {
+            if (verbose) Serial.printf("No data from %s sensor yet\n", sensor->name);
+            continue;
+        }
+        unsigned long age = millis() - sensor->lastSeen;
+        if (age < MAX_DATA_AGE) {
+            cells[i].data = sensor->data;
+            cells[i].fresh = true;
+            if (verbose) Serial.printf("%s data: S=%d%%, B=%d%% (age: %lu min)\n", sensor->name,
+                                      sensor->data.soilMoisture, sensor->data.batteryPercent, age/60000);
+        } else if (verbose) {
+            Serial.printf("%s data too old (%lu min), not displaying\n", sensor->name, age/60000);
+        }
+    }
+    
+    // Always show trams with weather and sensor sections (even if sensor data is missing)
+    if (verbose) {
+        if (hasWeather) {
+            Serial.println("Displaying: Trams + Weather + Multi-Sensor");
+        } else {
+            Serial.println("Displaying: Trams + Multi-Sensor (no weather yet)");
+        }
+    }
+    // For now, still show the full display even without weather
+    bool drawn = showTramsWithWeatherAndSensor(trams, currentWeather, cells, page, pages);
+    if (!drawn && verbose) Serial.println("Display unchanged, redraw skipped");
+    return drawn;
+#endif
+}
+
+// Boot progress goes to the screen only while there is no board to show;
+// the pause keeps each message readable
+void bootStatus(const char* msg, unsigned long pauseMs = 0) {
+    Serial.printf("Boot: %s\n", msg);
+    if (showingSnapshot) return;
+    showMessage(msg);
+    delay(pauseMs);
+}
+
+// Put the last saved board on screen before any network activity
+void showSnapshot() {
+    time_t savedAt;
+    if (!loadSnapshot(trams, currentWeather, savedAt)) return;
+    
+    setBoardStale(true, savedAt);
+    if (renderBoard(false)) {
+        showingSnapshot = true;
+        firstFrameMs = millis();
+        Serial.printf("Time to first frame: %lu ms (snapshot from flash)\n", firstFrameMs);
     } else {
-        Serial.println("WARNING: Time sync failed!");
+        Serial.println("Snapshot has no upcoming departures, not shown");
+    }
+}
+
+// Take over data fetched by the network task
+void applyNetResult(const NetResult& result) {
+    jobsInFlight &= ~result.jobs;
+    
+    if ((result.jobs & NET_JOB_WEATHER) && result.weatherOk) {
+        currentWeather = result.weather;
+    }
+    
+    if (!(result.jobs & NET_JOB_TRAMS)) return;
+    
+    trams = result.trams;
+    FetchResult fetchResult = result.tramResult;
+    cycleStats.cycles++;
+    if (fetchResult == FETCH_NOT_MODIFIED) cycleStats.networkSkipped++;
+    if (fetchResult == FETCH_NOT_MODIFIED || fetchResult == FETCH_UNCHANGED) cycleStats.parseSkipped++;
+    
+    Serial.println("========================================");
+    Serial.printf("Network task finished in %lu ms\n", (unsigned long)result.durationMs);
+    if (fetchResult == FETCH_FAILED) {
+        Serial.println("ERROR: Fetch failed, counting down the departures we have");
+    }
+    
+    pollRecordFetch(fetchResult);
+    nextFetchDelay = pollNextInterval(trams, time(nullptr));
+    const PollStats& poll = getPollStats();
+    Serial.printf("Next fetch in %lu s (range %lu-%lu s, volatility %.2f)\n",
+                 (unsigned long)(nextFetchDelay / 1000), (unsigned long)(poll.minIntervalMs / 1000),
+                 (unsigned long)(poll.maxIntervalMs / 1000), poll.volatility);
+    
+    if (fetchResult != FETCH_FAILED) {
+        setBoardStale(false, 0);
+        saveSnapshot(trams, currentWeather);
+    }
+    
+    // Draw right away instead of waiting for the next render tick
+    lastRender = millis();
+    if (!renderBoard(true)) cycleStats.renderSkipped++;
+    if (fetchResult != FETCH_FAILED && firstLiveFrameMs == 0) {
+        firstLiveFrameMs = millis();
+        if (firstFrameMs == 0) firstFrameMs = firstLiveFrameMs;
+        Serial.printf("Time to first frame: %lu ms, first live frame: %lu ms\n",
+                     firstFrameMs, firstLiveFrameMs);
     }
+    // The board just drawn is also what the display keeps for its diff, so
+    // none of the ids it compares against can be freed and handed out again
+    if (jobsInFlight == 0 && strPoolWantsSweep()) reclaimTramStrings(trams);
+    Serial.printf("Cycles: %lu, skipped at network: %lu, parse: %lu, render: %lu\n",
+                 (unsigned long)cycleStats.cycles, (unsigned long)cycleStats.networkSkipped,
+                 (unsigned long)cycleStats.parseSkipped, (unsigned long)cycleStats.renderSkipped);
+    Serial.printf("Max main loop stall: %lu ms\n", (unsigned long)maxLoopStallMs);
+    static const char* const clockSources[] = { "not set", "restored", "SNTP" };
+    Serial.printf("Clock: %s, drift %.1f ppm\n", clockSources[getClockSource()], getClockDriftPpm());
+    const WifiConnectStats& wifi = getWiFiConnectStats();
+    Serial.printf("WiFi: last connect %lu ms (%s), %lu fast, %lu scanned, %lu fast failures\n",
+                 (unsigned long)wifi.lastConnectMs, wifi.lastFast ? "fast" : "scan",
+                 (unsigned long)wifi.fastConnects, (unsigned long)wifi.scanConnects,
+                 (unsigned long)wifi.fastFailures);
+    EspNowStats espNow = getEspNowStats();
+    Serial.printf("ESP-NOW: %lu packets, %lu dropped, %lu rejected, max queue depth %lu, %lu sensors (%lu refused)\n",
+                 (unsigned long)espNow.received, (unsigned long)espNow.dropped,
+                 (unsigned long)espNow.rejected, (unsigned long)espNow.maxQueueDepth,
+                 (unsigned long)espNow.sensors, (unsigned long)espNow.sensorsRefused);
+    Serial.printf("ESP-NOW frames: %lu duplicate, %lu out of order, %lu resynced; callback p50 <%lu us, p99 <%lu us, max %lu us\n",
+                 (unsigned long)espNow.duplicates, (unsigned long)espNow.reordered, (unsigned long)espNow.resynced,
+                 (unsigned long)espNow.callbackP50Us, (unsigned long)espNow.callbackP99Us,
+                 (unsigned long)espNow.callbackMaxUs);
+    Serial.println("========================================\n");
 }
 
 void setup() {
     Serial.begin(115200);
     delay(1000);
     Serial.println("\n\n=== TramReader Starting ===");
+    // Before anything reads the clock: after a reset it is usable right away
+    beginClock();
     Serial.printf("Free heap: %d bytes\n", ESP.getFreeHeap());
     
     // Initialize LED pin and blink 3 times fast to show we're alive
@@ -70,39 +232,25 @@ void setup() {
         }
     }
     
-    Serial.println("Showing startup message...");
-    showMessage("Starting...");
-    delay(1000);
+    showSnapshot();
     
-    showMessage("WiFi...");
-    if (connectWiFi()) {
-        showMessage("Connected!");
-        Serial.println("WiFi OK");
-        
-        // Sync time after WiFi connection
-        showMessage("Sync time...");
-        syncTime();
-    } else {
-        showMessage("WiFi Failed");
-        Serial.println("WiFi Failed");
-    }
+    Serial.println("Showing startup message...");
+    bootStatus("Starting...", 1000);
     
-    delay(2000);
+    // Connects and syncs the clock in the background, driven by tickWiFi()
+    bootStatus("WiFi...");
+    startWiFi();
     
     // Initialize ESP-NOW receiver
-    showMessage("ESP-NOW...");
+    bootStatus("ESP-NOW...");
     initESPNowReceiver();
-    delay(1000);
+    startEspNowLoadGen();
+    if (!showingSnapshot) delay(1000);
     
-    // Fetch weather immediately on startup
-    showMessage("Weather...");
-    Serial.println("Fetching initial weather data...");
-    if (fetchWeather(currentWeather)) {
-        Serial.println("Weather data loaded successfully!");
-    } else {
-        Serial.println("Failed to fetch weather on startup");
-    }
-    delay(1000);
+    // Weather and trams are fetched in the background as soon as the
+    // network (and, for trams, the clock) is there
+    startNetTask();
+    lastWeatherUpdate = millis() - WEATHER_UPDATE_INTERVAL;
     
     // Ensure LED stays off after setup complete
     digitalWrite(LED_PIN, LOW);
@@ -114,6 +262,7 @@ void setup() {
 void loop() {
     // Keep LED off during normal operation
     // Only blinked 3 times at startup
+    unsigned long loopStart = millis();
     
     // Update brightness every 5 minutes (check if we crossed into/out of night mode)
     if (millis() - lastBrightnessUpdate >= 5 * 60 * 1000) {
@@ -121,100 +270,58 @@ void loop() {
         updateBrightnessForTime();
     }
     
-    // Check WiFi connection and reconnect if needed
-    if (WiFi.status() != WL_CONNECTED) {
-        Serial.println("⚠️  WiFi disconnected! Reconnecting...");
-        showMessage("WiFi lost...");
-        if (connectWiFi()) {
-            showMessage("Reconnected!");
-            delay(1000);
-        } else {
-            showMessage("WiFi failed!");
-            delay(5000);
-            return;
+    // Reconnects on its own; while the link is down the board keeps
+    // counting down from the departures it already has
+    tickWiFi();
+    tickClock();
+    bool online = wifiConnected();
+    
+    // Queue due fetches; the network task does the actual work
+    uint8_t due = 0;
+    if (online && !(jobsInFlight & NET_JOB_WEATHER) && millis() - lastWeatherUpdate >= WEATHER_UPDATE_INTERVAL) {
+        due |= NET_JOB_WEATHER;  // Update weather every 10 minutes
+    }
+    // Departures are placed on the clock, so wait for it to be set
+    if (online && time(nullptr) > 100000 &&
+        !(jobsInFlight & NET_JOB_TRAMS) && millis() - lastUpdate >= nextFetchDelay) {
+        due |= NET_JOB_TRAMS;
+    }
+    if (due && requestNetJobs(due)) {
+        jobsInFlight |= due;
+        if (due & NET_JOB_WEATHER) lastWeatherUpdate = millis();
+        if (due & NET_JOB_TRAMS) {
+            lastUpdate = millis();
+            Serial.println("\n========================================");
+            Serial.println("STARTING TRAM DATA FETCH");
+            Serial.printf("WiFi Status: %s (RSSI: %d dBm)\n", 
+                         WiFi.status() == WL_CONNECTED ? "Connected" : "Disconnected",
+                         WiFi.RSSI());
+            Serial.println("========================================");
         }
     }
     
-    // Update weather every 10 minutes
-    if (millis() - lastWeatherUpdate >= WEATHER_UPDATE_INTERVAL) {
-        lastWeatherUpdate = millis();
-        Serial.println("Fetching weather data...");
-        fetchWeather(currentWeather);
-    }
-    
-    if (millis() - lastUpdate >= UPDATE_INTERVAL) {
-        lastUpdate = millis();
-        
-        Serial.println("\n========================================");
-        Serial.println("STARTING TRAM DATA FETCH");
-        Serial.printf("WiFi Status: %s (RSSI: %d dBm)\n", 
-                     WiFi.status() == WL_CONNECTED ? "Connected" : "Disconnected",
-                     WiFi.RSSI());
-        Serial.println("========================================");
-        
-        auto trams = fetchTrams();
-        
-        Serial.println("========================================");
-        if (!trams.empty()) {
-            Serial.printf("SUCCESS: Got %d trams, displaying now\n", trams.size());
-            
-            // Check what data we have available
-            bool hasWeather = currentWeather.valid;
-            
-            // Check for data from both sensors
-            bool hasOlga = hasSensorData(OLGA_MAC);
-            bool hasAE = hasSensorData(AE_MAC);
-            
-            // Get sensor data with age check (7 hours - sensors wake every 6 hours)
-            // Keep displaying data until next expected reading
-            const unsigned long MAX_DATA_AGE = 7UL * 60UL * 60UL * 1000UL; // 7 hours in milliseconds
-            
-            sensor_data_t olgaData = {};
-            sensor_data_t aeData = {};
-            
-            if (hasOlga) {
-                unsigned long olgaAge = millis() - getLastReceivedTime(OLGA_MAC);
-                if (olgaAge < MAX_DATA_AGE) {
-                    olgaData = getSensorData(OLGA_MAC);
-                    Serial.printf("Olga data: S=%d%%, B=%d%% (age: %lu min)\n", 
-                                 olgaData.soilMoisture, olgaData.batteryPercent, olgaAge/60000);
-                } else {
-                    Serial.printf("Olga data too old (%lu min), not displaying\n", olgaAge/60000);
-                    hasOlga = false;
-                }
-            } else {
-                Serial.println("No data from Olga sensor yet");
-            }
-            
-            if (hasAE) {
-                unsigned long aeAge = millis() - getLastReceivedTime(AE_MAC);
-                if (aeAge < MAX_DATA_AGE) {
-                    aeData = getSensorData(AE_MAC);
-                    Serial.printf("A&E data: S=%d%%, B=%d%% (age: %lu min)\n", 
-                                 aeData.soilMoisture, aeData.batteryPercent, aeAge/60000);
-                } else {
-                    Serial.printf("A&E data too old (%lu min), not displaying\n", aeAge/60000);
-                    hasAE = false;
-                }
-            } else {
-                Serial.println("No data from A&E sensor yet");
-            }
-            
-            // Always show trams with weather and sensor sections (even if sensor data is missing)
-            if (hasWeather) {
-                Serial.println("Displaying: Trams + Weather + Multi-Sensor");
-                showTramsWithWeatherAndSensor(trams, currentWeather, olgaData, aeData, hasOlga, hasAE);
-            } else {
-                Serial.println("Displaying: Trams + Multi-Sensor (no weather yet)");
-                // For now, still show the full display even without weather
-                showTramsWithWeatherAndSensor(trams, currentWeather, olgaData, aeData, hasOlga, hasAE);
-            }
-        } else {
-            Serial.println("ERROR: No trams returned from API");
-            showDebugInfo("No data", getLastHttpCode(), getLastHtmlSize(), getLastFoundEntries());
-        }
-        Serial.println("========================================\n");
+    processSensorPackets();
+    flushSensorHistory();
+    
+    NetResult result;
+    if (pollNetResult(result)) {
+        applyNetResult(result);
     }
     
+    // Countdown is recomputed locally from absolute departure times
+    if (millis() - lastRender >= RENDER_INTERVAL) {
+        lastRender = millis();
+        renderBoard(false);
+    }
+    
+    tickTramScroll();
+    
+    uint32_t stall = millis() - loopStart;
+    if (stall > maxLoopStallMs) maxLoopStallMs = stall;
+    
+#if BOARD_LAYOUT_LIST
+    delay(TRAM_SCROLL_FRAME_MS / 2);  // Keep the scroll at its frame rate
+#else
     delay(100);
+#endif
 }
@@ -0,0 +1,59 @@
+#include "net_task.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+
+#define NET_TASK_STACK    12288  // TLS handshakes need a deep stack
+#define NET_TASK_PRIORITY 1      // Same as loop(), so rendering is not starved
+#define NET_QUEUE_LENGTH  2
+
+static QueueHandle_t jobQueue = nullptr;
+static QueueHandle_t resultQueue = nullptr;
+
+// Owned by the task: fetchTrams() keeps its table between runs
+static DepartureTable taskTrams;
+static Weather taskWeather;
+static NetResult taskResult;
+
+static void netTask(void* arg) {
+    uint8_t jobs;
+    for (;;) {
+        if (xQueueReceive(jobQueue, &jobs, portMAX_DELAY) != pdTRUE) continue;
+        
+        unsigned long start = millis();
+        taskResult.jobs = jobs;
+        
+        if (jobs & NET_JOB_WEATHER) {
+            Serial.println("Fetching weather data...");
+            taskResult.weatherOk = fetchWeather(taskWeather);
+            taskResult.weather = taskWeather;
+        }
+        
+        if (jobs & NET_JOB_TRAMS) {
+            taskResult.tramResult = fetchTrams(taskTrams);
+            taskResult.trams = taskTrams;
+        }
+        
+        taskResult.durationMs = millis() - start;
+        xQueueSend(resultQueue, &taskResult, portMAX_DELAY);
+    }
+}
+
+void startNetTask() {
+    if (jobQueue != nullptr) return;
+    
+    jobQueue = xQueueCreate(NET_QUEUE_LENGTH, sizeof(uint8_t));
+    resultQueue = xQueueCreate(NET_QUEUE_LENGTH, sizeof(NetResult));
+    xTaskCreate(netTask, "net", NET_TASK_STACK, nullptr, NET_TASK_PRIORITY, nullptr);
+    Serial.println("Network task started");
+}
+
+bool requestNetJobs(uint8_t jobs) {
+    if (jobQueue == nullptr || jobs == 0) return false;
+    return xQueueSend(jobQueue, &jobs, 0) == pdTRUE;
+}
+
+bool pollNetResult(NetResult& result) {
+    if (resultQueue == nullptr) return false;
+    return xQueueReceive(resultQueue, &result, 0) == pdTRUE;
+}
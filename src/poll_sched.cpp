@@ -0,0 +1,58 @@
+#include "poll_sched.h"
+#include "config.h"
+
+#define VOLATILITY_ALPHA 0.25f  // Weight of the newest fetch in the average
+
+static PollStats stats = { 0, 0, 0, UINT32_MAX, 0, 0.5f };
+
+void pollRecordFetch(FetchResult result) {
+    // Failures say nothing about how often the data changes
+    if (result == FETCH_FAILED) return;
+    
+    bool changed = (result == FETCH_UPDATED);
+    stats.fetches++;
+    if (changed) stats.changed++;
+    stats.volatility += VOLATILITY_ALPHA * ((changed ? 1.0f : 0.0f) - stats.volatility);
+}
+
+static bool isNightHour(int hour) {
+    if (POLL_NIGHT_START_HOUR <= POLL_NIGHT_END_HOUR) {
+        return hour >= POLL_NIGHT_START_HOUR && hour < POLL_NIGHT_END_HOUR;
+    }
+    // Window wraps around midnight
+    return hour >= POLL_NIGHT_START_HOUR || hour < POLL_NIGHT_END_HOUR;
+}
+
+static uint32_t chooseInterval(const DepartureTable& trams, time_t now) {
+    if (now < 100000) return POLL_MIN_INTERVAL;  // No clock yet, stay responsive
+    
+    if (trams.empty()) {
+        struct tm ti;
+        localtime_r(&now, &ti);
+        return isNightHour(ti.tm_hour) ? POLL_NIGHT_INTERVAL : POLL_MAX_INTERVAL;
+    }
+    
+    // A third of the wait for the next tram: a delay announced now still
+    // reaches the board a couple of times before it arrives
+    int mins = tramMinutes(trams[0], now);
+    uint32_t interval = (uint32_t)(mins > 0 ? mins : 0) * 60000UL / 3;
+    
+    // Data that keeps changing is polled up to twice as often
+    interval = (uint32_t)(interval * (1.0f - 0.5f * stats.volatility));
+    
+    if (interval < POLL_MIN_INTERVAL) interval = POLL_MIN_INTERVAL;
+    if (interval > POLL_MAX_INTERVAL) interval = POLL_MAX_INTERVAL;
+    return interval;
+}
+
+uint32_t pollNextInterval(const DepartureTable& trams, time_t now) {
+    uint32_t interval = chooseInterval(trams, now);
+    stats.lastIntervalMs = interval;
+    if (interval < stats.minIntervalMs) stats.minIntervalMs = interval;
+    if (interval > stats.maxIntervalMs) stats.maxIntervalMs = interval;
+    return interval;
+}
+
+const PollStats& getPollStats() {
+    return stats;
+}
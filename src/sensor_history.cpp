@@ -0,0 +1,288 @@
+#include "sensor_history.h"
+#include "config.h"
+#include <Preferences.h>
+
+#define HISTORY_VERSION 2  // Bump when SensorHistory changes
+#define HOUR_SECONDS 3600UL
+#define DAY_SECONDS  86400UL
+
+struct HistoryBucket {
+    uint32_t period;     // time / bucket length; 0 = empty
+    uint32_t sum[2];     // Per HistoryMetric
+    uint8_t min[2];
+    uint8_t max[2];
+    uint16_t count;      // Readings in sum; a full bucket takes no more
+};
+
+struct SensorHistory {
+    uint8_t version;
+    uint64_t mac;        // 0 = unused
+    // Raw readings: the oldest is kept absolute in base, every later one
+    // is stored as deltas to the one before it
+    HistoryReading base;
+    HistoryReading last;
+    uint16_t records;    // Encoded readings after base
+    uint16_t head;       // First byte of the oldest encoded reading
+    uint16_t used;       // Bytes in the ring
+    bool trimmed;        // Readings before base were dropped to make room
+    uint8_t raw[HISTORY_RAW_BYTES];
+    HistoryBucket hours[HISTORY_HOURS];
+    HistoryBucket days[HISTORY_DAYS];
+};
+
+static SensorHistory histories[HISTORY_SENSORS];
+static bool dirty[HISTORY_SENSORS];
+static unsigned long lastFlush = 0;
+
+// ===== Varint helpers =====
+
+static uint32_t zigzag(int32_t v) {
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static int32_t unzigzag(uint32_t v) {
+    return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+}
+
+static int putVarint(uint8_t* out, uint32_t v) {
+    int n = 0;
+    while (v >= 0x80) {
+        out[n++] = (uint8_t)v | 0x80;
+        v >>= 7;
+    }
+    out[n++] = (uint8_t)v;
+    return n;
+}
+
+// Read a varint from the ring at pos, advancing pos
+static uint32_t getVarint(const SensorHistory& h, uint16_t& pos) {
+    uint32_t v = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        uint8_t b = h.raw[pos];
+        pos = (pos + 1) % HISTORY_RAW_BYTES;
+        v |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) break;
+    }
+    return v;
+}
+
+// Apply the encoded reading at pos to r
+static void decodeNext(const SensorHistory& h, uint16_t& pos, HistoryReading& r) {
+    r.time += getVarint(h, pos);
+    r.moisture += unzigzag(getVarint(h, pos));
+    r.battery += unzigzag(getVarint(h, pos));
+}
+
+// ===== Storage =====
+
+static void loadHistory(SensorHistory& h, uint64_t mac) {
+#if HISTORY_FLASH
+    char key[16];
+    snprintf(key, sizeof(key), "h%012llx", (unsigned long long)mac);
+    Preferences prefs;
+    if (prefs.begin("history", true)) {
+        bool ok = prefs.getBytesLength(key) == sizeof(h) && prefs.getBytes(key, &h, sizeof(h)) == sizeof(h);
+        prefs.end();
+        if (ok && h.version == HISTORY_VERSION && h.mac == mac) {
+            Serial.printf("History for %012llx restored: %u readings\n", (unsigned long long)mac, h.records + 1);
+            return;
+        }
+    }
+#endif
+    memset(&h, 0, sizeof(h));
+    h.version = HISTORY_VERSION;
+    h.mac = mac;
+}
+
+#if HISTORY_FLASH
+static bool saveHistory(Preferences& prefs, int i) {
+    char key[16];
+    snprintf(key, sizeof(key), "h%012llx", (unsigned long long)histories[i].mac);
+    if (prefs.putBytes(key, &histories[i], sizeof(SensorHistory)) != sizeof(SensorHistory)) return false;
+    dirty[i] = false;
+    Serial.printf("History for %012llx saved (%u bytes)\n",
+                 (unsigned long long)histories[i].mac, (unsigned)sizeof(SensorHistory));
+    return true;
+}
+#endif
+
+// A free slot, else the one updated longest ago. Its unsaved readings go
+// to flash first, so the sensor picks up where it was if it comes back.
+static int claimSlot() {
+    int oldest = 0;
+    for (int i = 0; i < HISTORY_SENSORS; i++) {
+        if (histories[i].mac == 0) return i;
+        if (histories[i].last.time < histories[oldest].last.time) oldest = i;
+    }
+    Serial.printf("History for %012llx makes room\n", (unsigned long long)histories[oldest].mac);
+#if HISTORY_FLASH
+    if (dirty[oldest]) {
+        Preferences prefs;
+        if (prefs.begin("history", false)) {
+            saveHistory(prefs, oldest);
+            prefs.end();
+        }
+    }
+#endif
+    dirty[oldest] = false;
+    return oldest;
+}
+
+static int findHistory(uint64_t mac, bool create) {
+    for (int i = 0; i < HISTORY_SENSORS; i++) {
+        if (histories[i].mac == mac) return i;
+    }
+    if (!create) return -1;
+    int i = claimSlot();
+    loadHistory(histories[i], mac);
+    return i;
+}
+
+// ===== Recording =====
+
+static void addToBucket(HistoryBucket* buckets, int count, uint32_t length, uint32_t time, const uint8_t value[2]) {
+    uint32_t period = time / length;
+    HistoryBucket& b = buckets[period % count];
+    if (b.period != period) {
+        // Slot still holds an older period: start over
+        memset(&b, 0, sizeof(b));
+        b.period = period;
+        b.min[0] = b.min[1] = 0xFF;
+    }
+    if (b.count == 0xFFFF) return;  // Keeps sum and count in step
+    for (int m = 0; m < 2; m++) {
+        b.sum[m] += value[m];
+        if (value[m] < b.min[m]) b.min[m] = value[m];
+        if (value[m] > b.max[m]) b.max[m] = value[m];
+    }
+    b.count++;
+}
+
+static void appendRaw(SensorHistory& h, const HistoryReading& r) {
+    if (h.base.time == 0) {
+        h.base = r;
+        h.last = r;
+        return;
+    }
+
+    uint8_t rec[15];
+    int len = putVarint(rec, r.time - h.last.time);
+    len += putVarint(rec + len, zigzag((int32_t)r.moisture - h.last.moisture));
+    len += putVarint(rec + len, zigzag((int32_t)r.battery - h.last.battery));
+
+    // Make room by folding the oldest encoded readings into base
+    while (HISTORY_RAW_BYTES - h.used < len && h.records > 0) {
+        uint16_t pos = h.head;
+        decodeNext(h, pos, h.base);
+        h.used -= (pos + HISTORY_RAW_BYTES - h.head) % HISTORY_RAW_BYTES;
+        h.head = pos;
+        h.records--;
+        h.trimmed = true;
+    }
+
+    uint16_t tail = (h.head + h.used) % HISTORY_RAW_BYTES;
+    for (int i = 0; i < len; i++) h.raw[(tail + i) % HISTORY_RAW_BYTES] = rec[i];
+    h.used += len;
+    h.records++;
+    h.last = r;
+}
+
+void recordSensorHistory(uint64_t mac, const sensor_data_t& data, time_t now) {
+    if (now < 100000) return;  // Clock not set, readings could not be placed
+    int i = findHistory(mac, true);
+    if (i < 0) return;
+    SensorHistory& h = histories[i];
+    if (h.last.time != 0 && (uint32_t)now < h.last.time) return;  // Clock went back
+
+    HistoryReading r;
+    r.time = (uint32_t)now;
+    r.moisture = (uint8_t)constrain(data.soilMoisture, 0, 100);
+    r.battery = (uint8_t)constrain(data.batteryPercent, 0, 100);
+
+    appendRaw(h, r);
+    uint8_t value[2] = { r.moisture, r.battery };
+    addToBucket(h.hours, HISTORY_HOURS, HOUR_SECONDS, r.time, value);
+    addToBucket(h.days, HISTORY_DAYS, DAY_SECONDS, r.time, value);
+    dirty[i] = true;
+}
+
+// ===== Queries =====
+
+// Sparkline from the raw readings, which are in time order: one pass,
+// each point averages the readings that fall in it
+static void rawSparkline(const SensorHistory& h, HistoryMetric metric, uint32_t start, uint32_t seconds,
+                         uint8_t* out, int points) {
+    HistoryReading r = h.base;
+    uint16_t pos = h.head;
+    int k = 0;  // Readings decoded after base
+    for (int p = 0; p < points; p++) {
+        uint32_t to = start + (uint64_t)seconds * (p + 1) / points;
+        uint32_t sum = 0, n = 0;
+        while (r.time < to) {
+            if (r.time >= start) {
+                sum += metric == HISTORY_MOISTURE ? r.moisture : r.battery;
+                n++;
+            }
+            if (k == h.records) {
+                r.time = UINT32_MAX;  // No more readings
+                break;
+            }
+            decodeNext(h, pos, r);
+            k++;
+        }
+        out[p] = n > 0 ? (uint8_t)(sum / n) : HISTORY_NO_DATA;
+    }
+}
+
+int sensorSparkline(uint64_t mac, HistoryMetric metric, uint32_t seconds, time_t now,
+                    uint8_t* out, int points) {
+    int i = findHistory(mac, false);
+    if (i < 0 || points <= 0 || seconds == 0 || now < 100000) return 0;
+    const SensorHistory& h = histories[i];
+
+    // The raw readings are exact; use them while they reach back far enough.
+    // The ring is a fixed size, so this is as bounded as the buckets.
+    if (h.base.time != 0 && (!h.trimmed || h.base.time <= (uint32_t)now - seconds)) {
+        rawSparkline(h, metric, (uint32_t)now - seconds, seconds, out, points);
+        return points;
+    }
+
+    // Hourly buckets while the window fits in them, daily beyond that
+    bool hourly = seconds <= HISTORY_HOURS * HOUR_SECONDS;
+    const HistoryBucket* buckets = hourly ? h.hours : h.days;
+    int count = hourly ? HISTORY_HOURS : HISTORY_DAYS;
+    uint32_t length = hourly ? HOUR_SECONDS : DAY_SECONDS;
+    if (seconds > count * length) seconds = count * length;
+
+    uint32_t start = (uint32_t)now - seconds;
+    for (int p = 0; p < points; p++) {
+        uint32_t from = (start + (uint64_t)seconds * p / points) / length;
+        uint32_t to = (start + (uint64_t)seconds * (p + 1) / points - 1) / length;
+        uint32_t sum = 0, n = 0;
+        // At most `count` buckets over all points, whatever the history length
+        for (uint32_t period = from; period <= to; period++) {
+            const HistoryBucket& b = buckets[period % count];
+            if (b.period != period || b.count == 0) continue;
+            sum += b.sum[metric];
+            n += b.count;
+        }
+        out[p] = n > 0 ? (uint8_t)(sum / n) : HISTORY_NO_DATA;
+    }
+    return points;
+}
+
+void flushSensorHistory() {
+#if HISTORY_FLASH
+    if (lastFlush != 0 && millis() - lastFlush < HISTORY_FLUSH_INTERVAL) return;
+    lastFlush = millis();
+
+    Preferences prefs;
+    bool open = false;
+    for (int i = 0; i < HISTORY_SENSORS; i++) {
+        if (!dirty[i]) continue;
+        if (!open && !(open = prefs.begin("history", false))) return;
+        saveHistory(prefs, i);
+    }
+    if (open) prefs.end();
+#endif
+}
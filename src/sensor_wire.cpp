@@ -0,0 +1,52 @@
+#include "sensor_wire.h"
+
+static uint16_t get16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static void put16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+bool sensorWireParseHeader(const uint8_t* frame, size_t len, SensorWireHeader& header) {
+    if (len < SENSOR_WIRE_HEADER_SIZE + SENSOR_WIRE_READING_SIZE) return false;
+    if (frame[0] != SENSOR_WIRE_MAGIC || frame[1] != SENSOR_WIRE_VERSION) return false;
+    header.version = frame[1];
+    header.sequence = get16(frame + 2);
+    header.count = frame[4];
+    header.flags = frame[5];
+    return header.count >= 1 && header.count <= SENSOR_WIRE_MAX_READINGS &&
+           len == SENSOR_WIRE_HEADER_SIZE + (size_t)header.count * SENSOR_WIRE_READING_SIZE;
+}
+
+SensorWireReading sensorWireReading(const uint8_t* frame, uint8_t i) {
+    const uint8_t* p = frame + SENSOR_WIRE_HEADER_SIZE + i * SENSOR_WIRE_READING_SIZE;
+    SensorWireReading r;
+    r.batteryMv = get16(p);
+    r.batteryPercent = p[2];
+    r.moisturePermille = get16(p + 4);
+    r.ageSeconds = get16(p + 6);
+    return r;
+}
+
+size_t sensorWireEncode(uint8_t* frame, size_t size, uint16_t sequence, uint8_t flags,
+                        const SensorWireReading* readings, uint8_t count) {
+    size_t len = SENSOR_WIRE_HEADER_SIZE + (size_t)count * SENSOR_WIRE_READING_SIZE;
+    if (count == 0 || count > SENSOR_WIRE_MAX_READINGS || size < len) return 0;
+
+    frame[0] = SENSOR_WIRE_MAGIC;
+    frame[1] = SENSOR_WIRE_VERSION;
+    put16(frame + 2, sequence);
+    frame[4] = count;
+    frame[5] = flags;
+    for (uint8_t i = 0; i < count; i++) {
+        uint8_t* p = frame + SENSOR_WIRE_HEADER_SIZE + i * SENSOR_WIRE_READING_SIZE;
+        put16(p, readings[i].batteryMv);
+        p[2] = readings[i].batteryPercent;
+        p[3] = 0;
+        put16(p + 4, readings[i].moisturePermille);
+        put16(p + 6, readings[i].ageSeconds);
+    }
+    return len;
+}
@@ -0,0 +1,125 @@
+#include "snapshot.h"
+#include "config.h"
+#include "fingerprint.h"
+#include "str_pool.h"
+#include "drgl_parser.h"
+#include <Preferences.h>
+
+#define SNAPSHOT_NAMESPACE "snapshot"
+#define SNAPSHOT_KEY       "board"
+#define SNAPSHOT_VERSION   1  // Bump when SnapshotData changes
+
+// Interned ids do not survive a reset, so names are stored as text
+struct SnapshotTram {
+    uint32_t departs;
+    char line[DRGL_MAX_LINE + 1];
+    char dest[DRGL_MAX_DEST + 1];
+};
+
+struct SnapshotData {
+    uint8_t version;
+    uint8_t count;
+    bool weatherValid;
+    uint32_t savedAt;  // Epoch seconds
+    float temp;
+    float tempMin;
+    float tempMax;
+    float windSpeed;
+    SnapshotTram trams[MAX_TRAMS];
+};
+
+static SnapshotData data;           // Too large for the loop task's stack
+static uint32_t storedFingerprint = 0;
+static bool haveStored = false;
+static unsigned long lastWriteMs = 0;
+static bool written = false;
+
+// Fingerprint of everything but the save time, to spot identical boards
+static uint32_t snapshotFingerprint(SnapshotData& d) {
+    uint32_t savedAt = d.savedAt;
+    d.savedAt = 0;
+    uint32_t h = fingerprint(&d, sizeof(d));
+    d.savedAt = savedAt;
+    return h;
+}
+
+bool loadSnapshot(DepartureTable& table, Weather& weather, time_t& savedAt) {
+    Preferences prefs;
+    if (!prefs.begin(SNAPSHOT_NAMESPACE, true)) return false;
+    size_t len = prefs.getBytesLength(SNAPSHOT_KEY);
+    bool ok = len == sizeof(data) && prefs.getBytes(SNAPSHOT_KEY, &data, sizeof(data)) == sizeof(data);
+    prefs.end();
+    
+    if (!ok || data.version != SNAPSHOT_VERSION || data.count > MAX_TRAMS) {
+        Serial.println("No usable snapshot in flash");
+        return false;
+    }
+    
+    table.count = 0;
+    for (uint8_t i = 0; i < data.count; i++) {
+        SnapshotTram& t = data.trams[i];
+        t.line[DRGL_MAX_LINE] = '\0';
+        t.dest[DRGL_MAX_DEST] = '\0';
+        Tram& tram = table.trams[table.count++];
+        tram.line = internString(t.line);
+        tram.dest = internString(t.dest);
+        tram.departs = t.departs;
+    }
+    
+    weather.valid = data.weatherValid;
+    weather.temp = data.temp;
+    weather.tempMin = data.tempMin;
+    weather.tempMax = data.tempMax;
+    weather.windSpeed = data.windSpeed;
+    weather.description = "Clear";
+    savedAt = data.savedAt;
+    
+    storedFingerprint = snapshotFingerprint(data);
+    haveStored = true;
+    Serial.printf("Snapshot restored: %d departures, weather %s, saved at %lu\n",
+                 table.count, weather.valid ? "yes" : "no", (unsigned long)savedAt);
+    return true;
+}
+
+bool saveSnapshot(const DepartureTable& table, const Weather& weather) {
+    time_t now = time(nullptr);
+    if (now < 100000) return false;  // Departure times would be meaningless
+    if (written && millis() - lastWriteMs < SNAPSHOT_MIN_INTERVAL) return false;
+    
+    memset(&data, 0, sizeof(data));  // Padding too, it is part of the fingerprint
+    data.version = SNAPSHOT_VERSION;
+    data.count = table.count;
+    data.weatherValid = weather.valid;
+    data.savedAt = (uint32_t)now;
+    if (weather.valid) {
+        data.temp = weather.temp;
+        data.tempMin = weather.tempMin;
+        data.tempMax = weather.tempMax;
+        data.windSpeed = weather.windSpeed;
+    }
+    for (uint8_t i = 0; i < table.count; i++) {
+        SnapshotTram& t = data.trams[i];
+        t.departs = table.trams[i].departs;
+        strlcpy(t.line, tramLine(table.trams[i]), sizeof(t.line));
+        strlcpy(t.dest, tramDest(table.trams[i]), sizeof(t.dest));
+    }
+    
+    uint32_t h = snapshotFingerprint(data);
+    if (haveStored && h == storedFingerprint) return false;
+    
+    Preferences prefs;
+    if (!prefs.begin(SNAPSHOT_NAMESPACE, false)) return false;
+    bool ok = prefs.putBytes(SNAPSHOT_KEY, &data, sizeof(data)) == sizeof(data);
+    prefs.end();
+    if (!ok) {
+        Serial.println("ERROR: Writing snapshot failed");
+        return false;
+    }
+    
+    storedFingerprint = h;
+    haveStored = true;
+    written = true;
+    lastWriteMs = millis();
+    Serial.printf("Snapshot saved: %d departures (%u bytes)\n", table.count, (unsigned)sizeof(data));
+    return true;
+}
@@ -0,0 +1,118 @@
+#include "str_pool.h"
+#include "fingerprint.h"
+#include <Arduino.h>
+#include <string.h>
+
+#define STR_POOL_BUCKETS (STR_POOL_ENTRIES * 2)  // Keeps probe chains short
+
+static char poolChars[STR_POOL_BYTES];
+static uint16_t poolUsed = 0;
+static uint16_t entryOffset[STR_POOL_ENTRIES];
+static uint32_t entryHash[STR_POOL_ENTRIES];
+static bool entryLive[STR_POOL_ENTRIES];
+static bool entryMarked[STR_POOL_ENTRIES];
+static uint8_t entryCount = 0;  // Ids handed out so far, live or freed
+static uint8_t liveCount = 0;
+static uint8_t buckets[STR_POOL_BUCKETS];  // Entry id + 1, 0 = empty
+static uint16_t overflows = 0;             // Failed interns since the last sweep
+
+uint8_t internString(const char* s) {
+    uint32_t h = fingerprintStr(s);
+    size_t len = strlen(s);
+
+    // Linear probing; the table is never more than half full
+    size_t b = h % STR_POOL_BUCKETS;
+    while (buckets[b] != 0) {
+        uint8_t id = buckets[b] - 1;
+        if (entryHash[id] == h && strcmp(poolChars + entryOffset[id], s) == 0) {
+            return id;
+        }
+        b = (b + 1) % STR_POOL_BUCKETS;
+    }
+
+    // Reuse an id freed by the last sweep before handing out a new one
+    uint8_t id = 0;
+    while (id < entryCount && entryLive[id]) id++;
+
+    if (id >= STR_POOL_ENTRIES || poolUsed + len + 1 > STR_POOL_BYTES) {
+        if (overflows++ == 0) {
+            Serial.printf("String pool full (%u strings, %u bytes), \"%s\" shown as ?\n",
+                          (unsigned)liveCount, (unsigned)poolUsed, s);
+        }
+        return STR_NONE;
+    }
+
+    if (id == entryCount) entryCount++;
+    entryLive[id] = true;
+    liveCount++;
+    entryOffset[id] = poolUsed;
+    entryHash[id] = h;
+    memcpy(poolChars + poolUsed, s, len + 1);
+    poolUsed += len + 1;
+    buckets[b] = id + 1;
+    return id;
+}
+
+const char* pooledString(uint8_t id) {
+    if (id >= entryCount || !entryLive[id]) return "?";
+    return poolChars + entryOffset[id];
+}
+
+bool strPoolWantsSweep() {
+    return overflows > 0 || liveCount * 4 >= STR_POOL_ENTRIES * 3 || poolUsed * 4 >= STR_POOL_BYTES * 3;
+}
+
+void strPoolBeginSweep() {
+    memset(entryMarked, 0, sizeof(entryMarked));
+}
+
+void strPoolMark(uint8_t id) {
+    if (id < entryCount) entryMarked[id] = true;
+}
+
+void strPoolSweep() {
+    uint8_t before = liveCount;
+    uint16_t bytesBefore = poolUsed;
+
+    // Slide the surviving strings down in storage order, so the characters
+    // stay one contiguous run and the free space is all at the end
+    uint16_t packed = 0;
+    liveCount = 0;
+    for (;;) {
+        int next = -1;
+        for (uint8_t id = 0; id < entryCount; id++) {
+            if (entryLive[id] && entryOffset[id] >= packed &&
+                (next < 0 || entryOffset[id] < entryOffset[next])) {
+                next = id;
+            }
+        }
+        if (next < 0) break;
+        uint16_t len = strlen(poolChars + entryOffset[next]) + 1;
+        if (entryMarked[next]) {
+            memmove(poolChars + packed, poolChars + entryOffset[next], len);
+            entryOffset[next] = packed;
+            packed += len;
+            liveCount++;
+        } else {
+            entryLive[next] = false;
+        }
+    }
+    poolUsed = packed;
+
+    // Freed ids past the last live one can be handed out in order again
+    while (entryCount > 0 && !entryLive[entryCount - 1]) entryCount--;
+
+    // Rehash: deleting from a linear-probing table in place would break chains
+    memset(buckets, 0, sizeof(buckets));
+    for (uint8_t id = 0; id < entryCount; id++) {
+        if (!entryLive[id]) continue;
+        size_t b = entryHash[id] % STR_POOL_BUCKETS;
+        while (buckets[b] != 0) b = (b + 1) % STR_POOL_BUCKETS;
+        buckets[b] = id + 1;
+    }
+
+    Serial.printf("String pool sweep: %u -> %u strings, %u -> %u bytes, %u interns refused\n",
+                  (unsigned)before, (unsigned)liveCount, (unsigned)bytesBefore, (unsigned)poolUsed,
+                  (unsigned)overflows);
+    overflows = 0;
+}
@@ -0,0 +1,89 @@
+#include "subset_font.h"
+
+static const SubsetGlyph* findGlyph(const SubsetFont* font, char c) {
+    for (uint8_t i = 0; i < font->count; i++) {
+        if (font->glyphs[i].c == c) return &font->glyphs[i];
+    }
+    return nullptr;
+}
+
+// Walk the alternating background/foreground runs over the glyph box,
+// splitting foreground runs at row ends
+static void drawGlyph(Adafruit_GFX& g, const SubsetFont* font, const SubsetGlyph* glyph,
+                      int16_t x, int16_t y, uint16_t color) {
+    const uint8_t* p = font->data + glyph->offset;
+    const uint8_t* end = p + glyph->length;
+    uint8_t width = glyph->width;
+    int16_t gx = x + glyph->xOffset;
+    int16_t gy = y + glyph->yOffset;
+    uint16_t col = 0;
+    uint16_t row = 0;
+    bool foreground = false;
+
+    while (p < end) {
+        uint16_t run = *p++;
+        while (run > 0) {
+            uint16_t n = width - col < run ? width - col : run;
+            if (foreground) g.drawFastHLine(gx + col, gy + row, n, color);
+            run -= n;
+            col += n;
+            if (col == width) {
+                col = 0;
+                row++;
+            }
+        }
+        foreground = !foreground;
+    }
+}
+
+// The run cache this replaced fell back to the GFX font for characters it
+// did not hold; the full font is no longer linked, so say what is missing
+static void reportMissing(char c) {
+    static uint32_t reported[4];  // One bit per 7-bit character
+    uint8_t code = (uint8_t)c & 0x7F;
+    if (reported[code >> 5] & (1u << (code & 31))) return;
+    reported[code >> 5] |= 1u << (code & 31);
+    Serial.printf("Subset font has no '%c', add it to SUBSETS in scripts/font_subset.py\n", c);
+}
+
+void drawSubsetText(Adafruit_GFX& g, const SubsetFont* font, int16_t x, int16_t y, uint16_t color, const char* text) {
+    for (const char* c = text; *c; c++) {
+        const SubsetGlyph* glyph = findGlyph(font, *c);
+        if (glyph == nullptr) {
+            reportMissing(*c);
+            continue;
+        }
+        drawGlyph(g, font, glyph, x, y, color);
+        x += glyph->xAdvance;
+    }
+}
+
+void subsetTextBounds(const SubsetFont* font, const char* text, int16_t x, int16_t y,
+                      int16_t* x1, int16_t* y1, uint16_t* w, uint16_t* h) {
+    int16_t minX = INT16_MAX, minY = INT16_MAX, maxX = INT16_MIN, maxY = INT16_MIN;
+    for (const char* c = text; *c; c++) {
+        const SubsetGlyph* glyph = findGlyph(font, *c);
+        if (glyph == nullptr) continue;
+        if (glyph->width > 0 && glyph->height > 0) {
+            int16_t gx = x + glyph->xOffset;
+            int16_t gy = y + glyph->yOffset;
+            if (gx < minX) minX = gx;
+            if (gy < minY) minY = gy;
+            if (gx + glyph->width - 1 > maxX) maxX = gx + glyph->width - 1;
+            if (gy + glyph->height - 1 > maxY) maxY = gy + glyph->height - 1;
+        }
+        x += glyph->xAdvance;
+    }
+
+    if (maxX < minX) {
+        *x1 = x;
+        *y1 = y;
+        *w = 0;
+        *h = 0;
+        return;
+    }
+    *x1 = minX;
+    *y1 = minY;
+    *w = maxX - minX + 1;
+    *h = maxY - minY + 1;
+}
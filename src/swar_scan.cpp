@@ -0,0 +1,94 @@
+#include "swar_scan.h"
+#include <stdint.h>
+#include <string.h>
+
+// Native word: 32 bits on the ESP32-C3, 64 bits on a desktop host
+typedef uintptr_t word_t;
+
+static const word_t ONES  = (word_t)-1 / 0xFF;  // 0x0101...01
+static const word_t HIGHS = ONES << 7;          // 0x8080...80
+
+static inline word_t loadWord(const char* p) {
+    word_t w;
+    memcpy(&w, p, sizeof(w));
+    return w;
+}
+
+static inline word_t broadcast(char c) {
+    return ONES * (uint8_t)c;
+}
+
+// Non-zero when at least one byte of v is zero (exact for "any", not for "which")
+static inline word_t zeroBytes(word_t v) {
+    return (v - ONES) & ~v & HIGHS;
+}
+
+static inline bool isAligned(const char* p) {
+    return ((uintptr_t)p & (sizeof(word_t) - 1)) == 0;
+}
+
+static inline bool isDigitChar(char c) {
+    return (uint8_t)(c - '0') < 10;
+}
+
+size_t swarFindByte(const char* p, size_t n, char c) {
+    size_t i = 0;
+
+    // Scalar head until the pointer is word aligned
+    while (i < n && !isAligned(p + i)) {
+        if (p[i] == c) return i;
+        i++;
+    }
+
+    // Skip whole words that cannot contain c
+    word_t pattern = broadcast(c);
+    while (i + sizeof(word_t) <= n && !zeroBytes(loadWord(p + i) ^ pattern)) {
+        i += sizeof(word_t);
+    }
+
+    // Pin down the byte in the flagged word, or finish the tail
+    for (; i < n; i++) {
+        if (p[i] == c) return i;
+    }
+    return n;
+}
+
+size_t swarFindAny3(const char* p, size_t n, char a, char b, char c) {
+    size_t i = 0;
+
+    while (i < n && !isAligned(p + i)) {
+        if (p[i] == a || p[i] == b || p[i] == c) return i;
+        i++;
+    }
+
+    word_t pa = broadcast(a);
+    word_t pb = broadcast(b);
+    word_t pc = broadcast(c);
+    while (i + sizeof(word_t) <= n) {
+        word_t w = loadWord(p + i);
+        if (zeroBytes(w ^ pa) | zeroBytes(w ^ pb) | zeroBytes(w ^ pc)) break;
+        i += sizeof(word_t);
+    }
+
+    for (; i < n; i++) {
+        if (p[i] == a || p[i] == b || p[i] == c) return i;
+    }
+    return n;
+}
+
+size_t swarFindTime(const char* p, size_t n) {
+    if (n < 5) return n;
+
+    // Find each ':' with room for two digits on both sides, then check the digits
+    size_t i = 2;
+    while (i + 2 < n) {
+        size_t k = i + swarFindByte(p + i, n - 2 - i, ':');
+        if (k >= n - 2) break;
+        if (isDigitChar(p[k - 2]) && isDigitChar(p[k - 1]) &&
+            isDigitChar(p[k + 1]) && isDigitChar(p[k + 2])) {
+            return k - 2;
+        }
+        i = k + 1;
+    }
+    return n;
+}
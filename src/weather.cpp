@@ -1,56 +1,68 @@
 #include "weather.h"
 #include "config.h"
-#include <HTTPClient.h>
+#include "http_conn.h"
 #include <ArduinoJson.h>
 
+#define WEATHER_BODY_SIZE 2048  // Open-Meteo answers with well under 1 kB
+
 bool fetchWeather(Weather& weather) {
-  HTTPClient http;
-  
   // Open-Meteo API - no API key needed!
-  String url = "https://api.open-meteo.com/v1/forecast?latitude=" + 
-               String(WEATHER_LAT) + "&longitude=" + String(WEATHER_LON) + 
-               "&current=temperature_2m,wind_speed_10m&daily=temperature_2m_max,temperature_2m_min&timezone=Europe%2FAmsterdam";
-  
+  const char* url = "https://api.open-meteo.com/v1/forecast?latitude=" WEATHER_LAT
+                    "&longitude=" WEATHER_LON
+                    "&current=temperature_2m,wind_speed_10m&daily=temperature_2m_max,temperature_2m_min&timezone=Europe%2FAmsterdam";
+
   Serial.println("Fetching weather from Open-Meteo...");
-  http.begin(url);
-  
-  int httpCode = http.GET();
-  
+
+  HttpBody body;
+  int httpCode = httpGet(HOST_WEATHER, url, body);
+
   if (httpCode == 200) {
-    String payload = http.getString();
+    static char payload[WEATHER_BODY_SIZE];
+    size_t length = 0;
+    int n;
+    while (length < sizeof(payload) &&
+           (n = httpRead(body, payload + length, sizeof(payload) - length)) > 0) {
+      length += n;
+    }
+    bool complete = body.done;
+    httpFinish(body, true);
+
     Serial.println("Weather data received");
-    Serial.println("Payload length: " + String(payload.length()));
-    
+    Serial.printf("Payload length: %u\n", (unsigned)length);
+
+    if (!complete) {
+      Serial.println("Weather payload incomplete or too large");
+      return false;
+    }
+
     StaticJsonDocument<2048> doc;
-    DeserializationError error = deserializeJson(doc, payload);
-    
+    DeserializationError error = deserializeJson(doc, payload, length);
+
     if (error) {
       Serial.print("JSON parsing failed: ");
       Serial.println(error.c_str());
-      http.end();
       return false;
     }
-    
+
     // Get current temperature and wind speed
     weather.temp = doc["current"]["temperature_2m"];
     float windSpeedKmh = doc["current"]["wind_speed_10m"];
     weather.windSpeed = windSpeedKmh / 3.6;  // Convert km/h to m/s
-    
+
     // Get today's min/max from daily forecast
     weather.tempMin = doc["daily"]["temperature_2m_min"][0];
     weather.tempMax = doc["daily"]["temperature_2m_max"][0];
-    
+
     weather.description = "Clear";
     weather.valid = true;
-    
-    Serial.printf("Weather: %.1f°C (%.1f-%.1f), Wind: %.1f m/s\n", 
+
+    Serial.printf("Weather: %.1f°C (%.1f-%.1f), Wind: %.1f m/s\n",
                   weather.temp, weather.tempMin, weather.tempMax, weather.windSpeed);
-    
-    http.end();
+
     return true;
   } else {
     Serial.printf("Weather fetch failed: %d\n", httpCode);
-    http.end();
+    if (httpCode > 0) httpFinish(body, true);
     return false;
   }
 }
@@ -1,45 +1,130 @@
 #include "wifi_mgr.h"
 #include "config.h"
+#include "clock_keeper.h"
 #include <WiFi.h>
 #include <esp_wifi.h>
+#include <Preferences.h>
+#include <esp_sntp.h>
+#include <time.h>
+#include <atomic>
 
-// Store BSSID for locking
-static uint8_t savedBSSID[6] = {0};
-static bool hasSavedBSSID = false;
+#define WIFI_CACHE_VERSION 2
 
-// WiFi event handler for debugging
-void WiFiEvent(WiFiEvent_t event) {
-    Serial.printf("[WiFi Event] ");
-    switch(event) {
-        case ARDUINO_EVENT_WIFI_STA_GOT_IP:
-            Serial.println("Got IP");
-            break;
-        case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
-            Serial.println("Disconnected!");
-            break;
-        case ARDUINO_EVENT_WIFI_STA_CONNECTED:
-            Serial.println("Connected!");
-            break;
-        default:
-            Serial.printf("Event: %d\n", event);
-            break;
+// What the last good connection used, kept in flash so a reboot can skip
+// the scan (BSSID and channel) and DHCP (the lease)
+struct WifiCache {
+    uint8_t version;
+    uint8_t bssid[6];
+    uint8_t channel;
+    uint32_t ip;
+    uint32_t gateway;
+    uint32_t subnet;
+    uint32_t dns;
+    uint32_t leaseTime;  // Epoch seconds when DHCP gave ip; 0 = unknown
+};
+
+static WifiCache cache;
+static bool hasCache = false;
+static bool leaseReused = false;  // The current attempt skipped DHCP
+static bool cacheLoaded = false;
+static bool radioReady = false;
+static WifiConnectStats stats;
+
+// Set by the WiFi and SNTP callbacks, handled by tickWiFi() in loop()
+#define EVENT_GOT_IP       0x01
+#define EVENT_DISCONNECTED 0x02
+#define EVENT_TIME_SYNCED  0x04
+static std::atomic<uint8_t> pendingEvents{0};
+static std::atomic<uint8_t> disconnectReason{0};
+
+static LinkState state = LINK_IDLE;
+static unsigned long stateSince = 0;    // millis() when state was entered
+static unsigned long attemptStart = 0;  // First attempt since the link was last up
+static unsigned long backoffMs = 0;     // Wait before the next attempt, doubles per failure
+static bool timeSynced = false;
+
+static void printBSSID(const char* label, const uint8_t* bssid) {
+    Serial.print(label);
+    for (int i = 0; i < 6; i++) {
+        Serial.printf("%02X%s", bssid[i], i < 5 ? ":" : "");
     }
+    Serial.println();
 }
 
-bool connectWiFi() {
-    Serial.println("\n=== WiFi Connection ===");
-    Serial.printf("SSID: %s\n", WIFI_SSID);
+static void loadCache() {
+    if (cacheLoaded) return;
+    cacheLoaded = true;
+    Preferences prefs;
+    if (!prefs.begin("wifi", true)) return;
+    hasCache = prefs.getBytesLength("cache") == sizeof(cache) &&
+               prefs.getBytes("cache", &cache, sizeof(cache)) == sizeof(cache) &&
+               cache.version == WIFI_CACHE_VERSION && cache.channel != 0;
+    prefs.end();
+}
+
+// Remember the connection just made; flash is only written when it changed
+static void saveCache() {
+    WifiCache now = {};
+    now.version = WIFI_CACHE_VERSION;
+    uint8_t* bssid = WiFi.BSSID();
+    if (bssid == nullptr) return;
+    memcpy(now.bssid, bssid, 6);
+    now.channel = WiFi.channel();
+    now.ip = WiFi.localIP();
+    now.gateway = WiFi.gatewayIP();
+    now.subnet = WiFi.subnetMask();
+    now.dns = WiFi.dnsIP(0);
+    // A reused lease keeps the time DHCP gave it, so reuse cannot extend it
+    time_t t = time(nullptr);
+    now.leaseTime = leaseReused ? cache.leaseTime : (t > 100000 ? (uint32_t)t : 0);
     
-    // Register WiFi event handler
-    WiFi.onEvent(WiFiEvent);
+    if (hasCache && memcmp(&now, &cache, sizeof(cache)) == 0) return;
+    cache = now;
+    hasCache = true;
+    Preferences prefs;
+    if (!prefs.begin("wifi", false)) return;
+    prefs.putBytes("cache", &cache, sizeof(cache));
+    prefs.end();
+    printBSSID("BSSID saved: ", cache.bssid);
+}
+
+// Without DHCP the lease is never renewed, so it is only reused while the
+// router surely still holds it for us. An unset clock cannot tell.
+static bool leaseReusable() {
+    time_t now = time(nullptr);
+    return WIFI_REUSE_LEASE && cache.ip != 0 && cache.leaseTime != 0 && now > 100000 &&
+           (uint32_t)now - cache.leaseTime < WIFI_LEASE_REUSE_S;
+}
+
+// Static address from config.h, else the cached lease on a fast connect
+// while it is fresh, else DHCP
+static void configureIP(bool fast) {
+    IPAddress ip, gateway, subnet, dns;
+    leaseReused = false;
+    if (ip.fromString(WIFI_STATIC_IP) && gateway.fromString(WIFI_STATIC_GATEWAY) &&
+        subnet.fromString(WIFI_STATIC_SUBNET)) {
+        if (!dns.fromString(WIFI_STATIC_DNS)) dns = gateway;
+        WiFi.config(ip, gateway, subnet, dns);
+    } else if (fast && leaseReusable()) {
+        leaseReused = true;
+        WiFi.config(IPAddress(cache.ip), IPAddress(cache.gateway), IPAddress(cache.subnet), IPAddress(cache.dns));
+    } else {
+        WiFi.config(INADDR_NONE, INADDR_NONE, INADDR_NONE);
+    }
+}
+
+// Radio settings survive reconnects, so they are applied once
+static void setupRadio() {
+    if (radioReady) return;
+    radioReady = true;
     
-    // Disconnect any previous connection
-    WiFi.disconnect(true);
-    delay(100);
+    // The cache above replaces the SDK's own copy in flash, and the state
+    // machine below decides when to reconnect
+    WiFi.persistent(false);
+    WiFi.setAutoReconnect(false);
     
     // Set WiFi mode
     WiFi.mode(WIFI_STA);
-    delay(100);
     
     // Set hostname
     WiFi.setHostname("TramReader");
@@ -56,76 +141,163 @@ bool connectWiFi() {
     // Set long range mode for better connectivity
     esp_wifi_set_protocol(WIFI_IF_STA, WIFI_PROTOCOL_11B | WIFI_PROTOCOL_11G | WIFI_PROTOCOL_11N);
     Serial.println("WiFi protocol set to 11bgn");
-    
-    // First connection: scan and connect
-    if (!hasSavedBSSID) {
-        Serial.println("First connection - scanning for best AP...");
+}
+
+// Runs in the WiFi event task: only flag what happened
+static void onWiFiEvent(WiFiEvent_t event, WiFiEventInfo_t info) {
+    switch (event) {
+        case ARDUINO_EVENT_WIFI_STA_GOT_IP:
+            pendingEvents.fetch_or(EVENT_GOT_IP);
+            break;
+        case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
+            disconnectReason.store(info.wifi_sta_disconnected.reason);
+            pendingEvents.fetch_or(EVENT_DISCONNECTED);
+            break;
+        default:
+            break;
+    }
+}
+
+// Runs in the SNTP task
+static void onTimeSync(struct timeval* tv) {
+    pendingEvents.fetch_or(EVENT_TIME_SYNCED);
+}
+
+static void enterState(LinkState next) {
+    state = next;
+    stateSince = millis();
+}
+
+// Start joining the AP; fast uses the saved BSSID, channel and lease
+static void beginAttempt(bool fast) {
+    if (state != LINK_FAST && state != LINK_SCAN) attemptStart = millis();
+    // Drop a half-finished attempt; the radio stays on
+    WiFi.disconnect();
+    configureIP(fast);
+    if (fast) {
+        // Known AP and channel: no scan, and no DHCP when the lease is reused
+        printBSSID("Fast connect to saved BSSID: ", cache.bssid);
+        Serial.printf("Channel: %d, %s\n", cache.channel, leaseReused ? "saved lease" : "new lease");
+        WiFi.begin(WIFI_SSID, WIFI_PASSWORD, cache.channel, cache.bssid);
+    } else {
+        Serial.println(hasCache ? "Scanning for best AP..." : "First connection - scanning for best AP...");
         WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
+    }
+    enterState(fast ? LINK_FAST : LINK_SCAN);
+}
+
+static void beginConnect() {
+    beginAttempt(WIFI_FAST_CONNECT && hasCache);
+}
+
+static void onConnected(bool fast) {
+    stats.lastConnectMs = millis() - attemptStart;
+    stats.lastFast = fast;
+    if (fast) {
+        stats.fastConnects++;
     } else {
-        // Use saved BSSID for faster reconnection
-        Serial.print("Connecting to saved BSSID: ");
-        for (int i = 0; i < 6; i++) {
-            Serial.printf("%02X%s", savedBSSID[i], i < 5 ? ":" : "");
-        }
-        Serial.println();
-        WiFi.begin(WIFI_SSID, WIFI_PASSWORD, 0, savedBSSID);
+        stats.scanConnects++;
     }
+    backoffMs = 0;
+    enterState(LINK_UP);
     
-    Serial.print("Connecting");
-    int tries = 0;
-    while (WiFi.status() != WL_CONNECTED && tries++ < 40) {
-        Serial.print(".");
-        delay(500);
-        
-        // Print status every 5 seconds
-        if (tries % 10 == 0) {
-            Serial.printf("\nStatus: %d, RSSI: %d dBm ", WiFi.status(), WiFi.RSSI());
-        }
+    Serial.println("✅ WiFi Connected!");
+    Serial.printf("IP: %s\n", WiFi.localIP().toString().c_str());
+    Serial.printf("RSSI: %d dBm\n", WiFi.RSSI());
+    Serial.printf("Channel: %d\n", WiFi.channel());
+    Serial.printf("Connected in %lu ms (%s)\n", (unsigned long)stats.lastConnectMs,
+                 !fast ? "full scan" : leaseReused ? "saved BSSID, channel and lease" : "saved BSSID and channel");
+    
+    // Save BSSID, channel and lease for future connections
+    saveCache();
+    
+    // SNTP keeps itself running from here, across reconnects
+    startClockSync();
+}
+
+static void onConnectFailed() {
+    Serial.printf("❌ WiFi Failed! Status: %d, last disconnect reason %u\n",
+                 WiFi.status(), disconnectReason.load());
+    backoffMs = backoffMs == 0 ? WIFI_BACKOFF_MIN_MS : min(backoffMs * 2, (unsigned long)WIFI_BACKOFF_MAX_MS);
+    Serial.printf("Next WiFi attempt in %lu s\n", backoffMs / 1000);
+    // The saved AP is kept: it may just be down for a moment
+    WiFi.disconnect();
+    enterState(LINK_BACKOFF);
+}
+
+void startWiFi() {
+    if (state != LINK_IDLE) return;
+    Serial.println("\n=== WiFi Connection ===");
+    Serial.printf("SSID: %s\n", WIFI_SSID);
+    
+    // Registered once; every later change is seen through these
+    WiFi.onEvent(onWiFiEvent);
+    sntp_set_time_sync_notification_cb(onTimeSync);
+    
+    setupRadio();
+    loadCache();
+    beginConnect();
+}
+
+void tickWiFi() {
+    uint8_t events = pendingEvents.exchange(0);
+    // A late GOT_IP from an abandoned attempt does not count
+    bool up = (events & EVENT_GOT_IP) && WiFi.status() == WL_CONNECTED;
+    
+    if (events & EVENT_TIME_SYNCED) {
+        timeSynced = true;
+        clockSynced();
     }
-    Serial.println();
     
-    if (WiFi.status() == WL_CONNECTED) {
-        Serial.println("✅ WiFi Connected!");
-        Serial.printf("IP: %s\n", WiFi.localIP().toString().c_str());
-        Serial.printf("RSSI: %d dBm\n", WiFi.RSSI());
-        Serial.printf("Channel: %d\n", WiFi.channel());
+    unsigned long inState = millis() - stateSince;
+    switch (state) {
+        case LINK_IDLE:
+            break;
         
-        // Save BSSID for future connections
-        uint8_t* bssid = WiFi.BSSID();
-        if (bssid != nullptr) {
-            memcpy(savedBSSID, bssid, 6);
-            hasSavedBSSID = true;
-            Serial.print("BSSID locked: ");
-            for (int i = 0; i < 6; i++) {
-                Serial.printf("%02X%s", savedBSSID[i], i < 5 ? ":" : "");
+        case LINK_FAST:
+            if (up) {
+                onConnected(true);
+            } else if (inState >= WIFI_FAST_TIMEOUT_MS) {
+                stats.fastFailures++;
+                Serial.println("Fast connect failed");
+                beginAttempt(false);
             }
-            Serial.println();
-        }
+            break;
         
-        return true;
-    } else {
-        Serial.printf("❌ WiFi Failed! Status: %d\n", WiFi.status());
+        case LINK_SCAN:
+            if (up) {
+                onConnected(false);
+            } else if (inState >= WIFI_CONNECT_TIMEOUT_MS) {
+                onConnectFailed();
+            }
+            break;
         
-        // Print status details
-        switch (WiFi.status()) {
-            case WL_NO_SSID_AVAIL:
-                Serial.println("SSID not found");
-                break;
-            case WL_CONNECT_FAILED:
-                Serial.println("Connection failed");
-                break;
-            case WL_CONNECTION_LOST:
-                Serial.println("Connection lost");
-                break;
-            case WL_DISCONNECTED:
-                Serial.println("Disconnected");
-                break;
-            default:
-                Serial.println("Unknown error");
-        }
+        case LINK_UP:
+            // The event carries the reason; the status also catches a missed event
+            if (WiFi.status() != WL_CONNECTED) {
+                Serial.printf("⚠️  WiFi disconnected (reason %u)! Reconnecting...\n", disconnectReason.load());
+                beginConnect();
+            }
+            break;
         
-        // Reset BSSID lock if connection fails
-        hasSavedBSSID = false;
-        return false;
+        case LINK_BACKOFF:
+            if (inState >= backoffMs) beginConnect();
+            break;
     }
 }
+
+bool wifiConnected() {
+    return state == LINK_UP;
+}
+
+bool timeIsSynced() {
+    return timeSynced;
+}
+
+LinkState getLinkState() {
+    return state;
+}
+
+const WifiConnectStats& getWiFiConnectStats() {
+    return stats;
+}
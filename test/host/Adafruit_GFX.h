@@ -0,0 +1,62 @@
+#ifndef HOST_ADAFRUIT_GFX_H
+#define HOST_ADAFRUIT_GFX_H
+// Host stand-in for Adafruit_GFX with the same drawing contract: primitives
+// end in drawPixel/fillRect, the built-in font is a 6x8 cell per character
+// with the cursor at its top-left. Glyph shapes are a small 3x5 font of the
+// stub's own, so rendered frames show where text goes, not Adafruit's
+// exact letterforms.
+#include <Arduino.h>
+#include "gfxfont.h"
+
+class Adafruit_GFX : public Print {
+public:
+    Adafruit_GFX(int16_t w, int16_t h);
+    virtual ~Adafruit_GFX() {}
+
+    virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+    virtual void startWrite() {}
+    virtual void endWrite() {}
+    virtual void writePixel(int16_t x, int16_t y, uint16_t color) { drawPixel(x, y, color); }
+    virtual void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) { fillRect(x, y, w, h, color); }
+    virtual void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) { drawFastHLine(x, y, w, color); }
+    virtual void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) { drawFastVLine(x, y, h, color); }
+    virtual void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+    virtual void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+    virtual void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+    virtual void fillScreen(uint16_t color) { fillRect(0, 0, _width, _height, color); }
+    virtual void setRotation(uint8_t r);
+
+    void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
+    void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+    void drawBitmap(int16_t x, int16_t y, const uint8_t* bitmap, int16_t w, int16_t h, uint16_t color);
+
+    void setCursor(int16_t x, int16_t y) { cursor_x = x; cursor_y = y; }
+    void setTextColor(uint16_t c) { textcolor = textbgcolor = c; }
+    void setTextColor(uint16_t c, uint16_t bg) { textcolor = c; textbgcolor = bg; }
+    void setTextSize(uint8_t s) { textsize = s > 0 ? s : 1; }
+    void setTextWrap(bool w) { wrap = w; }
+    void setFont(const GFXfont* f = nullptr) { (void)f; }
+    void getTextBounds(const char* s, int16_t x, int16_t y, int16_t* x1, int16_t* y1, uint16_t* w, uint16_t* h);
+
+    size_t write(uint8_t c) override;
+    using Print::write;
+
+    int16_t width() const { return _width; }
+    int16_t height() const { return _height; }
+    uint8_t getRotation() const { return rotation; }
+    int16_t getCursorX() const { return cursor_x; }
+    int16_t getCursorY() const { return cursor_y; }
+
+protected:
+    void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size);
+
+    const int16_t WIDTH, HEIGHT;  // Unrotated size
+    int16_t _width, _height;
+    int16_t cursor_x = 0, cursor_y = 0;
+    uint16_t textcolor = 0xFFFF, textbgcolor = 0xFFFF;
+    uint8_t textsize = 1;
+    uint8_t rotation = 0;
+    bool wrap = true;
+};
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef HOST_ADAFRUIT_SPITFT_H
+#define HOST_ADAFRUIT_SPITFT_H
+// Host stand-in for Adafruit_SPITFT: the panel is a RGB565 frame held in
+// memory. Like the real driver every primitive opens an address window and
+// streams pixels into it, so DisplayCost counting behaves the same.
+// Frame memory uses the coordinates of the current rotation.
+#include "Adafruit_GFX.h"
+#include <SPI.h>
+
+class Adafruit_SPITFT : public Adafruit_GFX {
+public:
+    Adafruit_SPITFT(uint16_t w, uint16_t h);
+    ~Adafruit_SPITFT() override;
+
+    virtual void setAddrWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+    void writePixels(uint16_t* colors, uint32_t len, bool block = true, bool bigEndian = false);
+    void writeColor(uint16_t color, uint32_t len);
+    void sendCommand(uint8_t cmd, const uint8_t* data = nullptr, uint8_t len = 0);
+    void invertDisplay(bool) {}
+
+    void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+    void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+    void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+    void setRotation(uint8_t r) override;
+
+    // Host only: the frame as the panel holds it, the pixel the viewer sees
+    // there after vertical scrolling, and the last VSCSAD value
+    uint16_t hostPixel(int16_t x, int16_t y) const;
+    uint16_t hostScreenPixel(int16_t x, int16_t y) const;
+    uint16_t hostScrollStart() const { return scrollStart; }
+
+private:
+    void putPixel(uint16_t color);
+
+    uint16_t* frame;
+    uint16_t winX = 0, winY = 0, winW = 0, winH = 0;
+    uint32_t winPos = 0;
+    uint16_t scrollStart = 0;
+};
+
+#endif
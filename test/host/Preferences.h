@@ -0,0 +1,25 @@
+#ifndef HOST_PREFERENCES_H
+#define HOST_PREFERENCES_H
+// Host stand-in for the ESP32 Preferences (NVS) API: byte blobs per
+// namespace, kept in memory for the life of the test process.
+#include <Arduino.h>
+#include <string>
+
+class Preferences {
+public:
+    bool begin(const char* name, bool readOnly = false);
+    void end();
+    size_t putBytes(const char* key, const void* value, size_t len);
+    size_t getBytes(const char* key, void* buf, size_t maxLen);
+    size_t getBytesLength(const char* key);
+
+private:
+    std::string ns;
+    bool open = false;
+    bool readOnly = true;
+};
+
+// Host only: forget everything stored, like an erased NVS partition
+void hostPreferencesClear();
+
+#endif
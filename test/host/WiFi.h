@@ -0,0 +1,12 @@
+#ifndef HOST_WIFI_H
+#define HOST_WIFI_H
+#include <Arduino.h>
+
+// The host has no radio: always disconnected
+class WiFiClass {
+public:
+    bool isConnected() const { return false; }
+};
+extern WiFiClass WiFi;
+
+#endif
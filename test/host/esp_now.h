@@ -0,0 +1,20 @@
+#ifndef HOST_ESP_NOW_H
+#define HOST_ESP_NOW_H
+// Host stand-in for ESP-NOW: no radio, frames are delivered by the test
+// through hostEspNowDeliver() to whichever callback is registered.
+#include <stdint.h>
+
+typedef int esp_err_t;
+#define ESP_OK   0
+#define ESP_FAIL -1
+
+typedef void (*esp_now_recv_cb_t)(const uint8_t* mac_addr, const uint8_t* data, int data_len);
+
+esp_err_t esp_now_init();
+esp_err_t esp_now_register_recv_cb(esp_now_recv_cb_t cb);
+esp_err_t esp_now_unregister_recv_cb();
+
+// Host only: a frame arriving over the air. False if nobody is listening.
+bool hostEspNowDeliver(const uint8_t* mac, const uint8_t* data, int len);
+
+#endif
@@ -0,0 +1,52 @@
+#include "Arduino.h"
+#include <chrono>
+#include <thread>
+
+HostSerial Serial;
+
+static const auto hostStart = std::chrono::steady_clock::now();
+static time_t pinnedTime = 0;
+
+unsigned long millis() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - hostStart).count();
+}
+
+unsigned long micros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - hostStart).count();
+}
+
+void delay(unsigned long ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+// No pins on the host: outputs go nowhere, inputs read low
+void pinMode(uint8_t, uint8_t) {}
+void digitalWrite(uint8_t, uint8_t) {}
+int digitalRead(uint8_t) { return LOW; }
+double ledcSetup(uint8_t, double freq, uint8_t) { return freq; }
+void ledcAttachPin(uint8_t, uint8_t) {}
+void ledcWrite(uint8_t, uint32_t) {}
+
+#if !defined(__GLIBC__) || !__GLIBC_PREREQ(2, 38)
+size_t strlcpy(char* dst, const char* src, size_t size) {
+    size_t len = strlen(src);
+    if (size > 0) {
+        size_t n = len < size - 1 ? len : size - 1;
+        memcpy(dst, src, n);
+        dst[n] = '\0';
+    }
+    return len;
+}
+#endif
+
+void hostSetTime(time_t t) {
+    pinnedTime = t;
+}
+
+extern "C" time_t __real_time(time_t* t);
+
+extern "C" time_t __wrap_time(time_t* t) {
+    if (pinnedTime == 0) return __real_time(t);
+    if (t != nullptr) *t = pinnedTime;
+    return pinnedTime;
+}
@@ -0,0 +1,231 @@
+#include "Adafruit_SPITFT.h"
+#include <ctype.h>
+#include <stdlib.h>
+
+// 3x5 glyphs, rows top to bottom, '1' = set. Lower case draws as upper case;
+// anything missing draws as a box.
+struct HostGlyph {
+    char c;
+    const char* rows;
+};
+
+static const HostGlyph hostFont[] = {
+    {' ', "000000000000000"}, {'0', "111101101101111"}, {'1', "010110010010111"},
+    {'2', "111001111100111"}, {'3', "111001111001111"}, {'4', "101101111001001"},
+    {'5', "111100111001111"}, {'6', "111100111101111"}, {'7', "111001010010010"},
+    {'8', "111101111101111"}, {'9', "111101111001111"}, {'A', "010101111101101"},
+    {'B', "110101110101110"}, {'C', "011100100100011"}, {'D', "110101101101110"},
+    {'E', "111100110100111"}, {'F', "111100110100100"}, {'G', "011100101101011"},
+    {'H', "101101111101101"}, {'I', "111010010010111"}, {'J', "001001001101010"},
+    {'K', "101101110101101"}, {'L', "100100100100111"}, {'M', "101111111101101"},
+    {'N', "110101101101101"}, {'O', "010101101101010"}, {'P', "110101110100100"},
+    {'Q', "010101101110011"}, {'R', "110101110101101"}, {'S', "011100010001110"},
+    {'T', "111010010010010"}, {'U', "101101101101111"}, {'V', "101101101101010"},
+    {'W', "101101111111101"}, {'X', "101101010101101"}, {'Y', "101101010010010"},
+    {'Z', "111001010100111"}, {':', "000010000010000"}, {'%', "101001010100101"},
+    {'/', "001001010100100"}, {'.', "000000000000010"}, {'-', "000000111000000"},
+    {'+', "000010111010000"}, {'*', "000101010101000"}, {'?', "111001010000010"},
+    {'(', "010100100100010"}, {')', "010001001001010"}, {'&', "010101010101011"},
+    {'\'', "010010000000000"}, {',', "000000000010100"}, {'=', "000111000111000"},
+};
+static const char* boxGlyph = "111101101101111";
+
+static const char* glyphRows(unsigned char c) {
+    c = toupper(c);
+    for (const HostGlyph& g : hostFont) {
+        if ((unsigned char)g.c == c) return g.rows;
+    }
+    return boxGlyph;
+}
+
+Adafruit_GFX::Adafruit_GFX(int16_t w, int16_t h) : WIDTH(w), HEIGHT(h), _width(w), _height(h) {}
+
+void Adafruit_GFX::setRotation(uint8_t r) {
+    rotation = r & 3;
+    _width = (rotation & 1) ? HEIGHT : WIDTH;
+    _height = (rotation & 1) ? WIDTH : HEIGHT;
+}
+
+void Adafruit_GFX::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    for (int16_t i = x; i < x + w; i++) drawFastVLine(i, y, h, color);
+}
+
+void Adafruit_GFX::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+    for (int16_t i = 0; i < w; i++) drawPixel(x + i, y, color);
+}
+
+void Adafruit_GFX::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+    for (int16_t i = 0; i < h; i++) drawPixel(x, y + i, color);
+}
+
+void Adafruit_GFX::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+    int16_t dx = abs(x1 - x0), dy = -abs(y1 - y0);
+    int16_t sx = x0 < x1 ? 1 : -1, sy = y0 < y1 ? 1 : -1;
+    int16_t err = dx + dy;
+    for (;;) {
+        drawPixel(x0, y0, color);
+        if (x0 == x1 && y0 == y1) break;
+        int16_t e2 = 2 * err;
+        if (e2 >= dy) { err += dy; x0 += sx; }
+        if (e2 <= dx) { err += dx; y0 += sy; }
+    }
+}
+
+void Adafruit_GFX::drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    drawFastHLine(x, y, w, color);
+    drawFastHLine(x, y + h - 1, w, color);
+    drawFastVLine(x, y, h, color);
+    drawFastVLine(x + w - 1, y, h, color);
+}
+
+// Rows padded to whole bytes, most significant bit first, like Adafruit GFX
+void Adafruit_GFX::drawBitmap(int16_t x, int16_t y, const uint8_t* bitmap, int16_t w, int16_t h, uint16_t color) {
+    int16_t byteWidth = (w + 7) / 8;
+    for (int16_t j = 0; j < h; j++) {
+        for (int16_t i = 0; i < w; i++) {
+            if (bitmap[j * byteWidth + i / 8] & (0x80 >> (i & 7))) drawPixel(x + i, y + j, color);
+        }
+    }
+}
+
+void Adafruit_GFX::drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size) {
+    const char* rows = glyphRows(c);
+    // The 3x5 shape sits in the 5x7 glyph area of the 6x8 cell
+    for (int8_t j = 0; j < 8; j++) {
+        for (int8_t i = 0; i < 6; i++) {
+            int8_t gx = i - 1, gy = j - 1;
+            bool on = gx >= 0 && gx < 3 && gy >= 0 && gy < 5 && rows[gy * 3 + gx] == '1';
+            if (!on && bg == color) continue;
+            fillRect(x + i * size, y + j * size, size, size, on ? color : bg);
+        }
+    }
+}
+
+size_t Adafruit_GFX::write(uint8_t c) {
+    if (c == '\n') {
+        cursor_x = 0;
+        cursor_y += 8 * textsize;
+    } else if (c != '\r') {
+        if (wrap && cursor_x + 6 * textsize > _width) {
+            cursor_x = 0;
+            cursor_y += 8 * textsize;
+        }
+        drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor, textsize);
+        cursor_x += 6 * textsize;
+    }
+    return 1;
+}
+
+void Adafruit_GFX::getTextBounds(const char* s, int16_t x, int16_t y, int16_t* x1, int16_t* y1, uint16_t* w, uint16_t* h) {
+    int16_t maxX = x, lineX = x, lineY = y;
+    bool any = false;
+    for (const char* p = s; *p; p++) {
+        if (*p == '\n') {
+            lineX = x;
+            lineY += 8 * textsize;
+        } else if (*p != '\r') {
+            lineX += 6 * textsize;
+            if (lineX > maxX) maxX = lineX;
+            any = true;
+        }
+    }
+    *x1 = x;
+    *y1 = y;
+    *w = any ? maxX - x : 0;
+    *h = any ? lineY - y + 8 * textsize : 0;
+}
+
+Adafruit_SPITFT::Adafruit_SPITFT(uint16_t w, uint16_t h) : Adafruit_GFX(w, h) {
+    frame = new uint16_t[(size_t)w * h]();
+}
+
+Adafruit_SPITFT::~Adafruit_SPITFT() {
+    delete[] frame;
+}
+
+void Adafruit_SPITFT::setRotation(uint8_t r) {
+    Adafruit_GFX::setRotation(r);
+}
+
+void Adafruit_SPITFT::setAddrWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
+    winX = x;
+    winY = y;
+    winW = w;
+    winH = h;
+    winPos = 0;
+}
+
+void Adafruit_SPITFT::putPixel(uint16_t color) {
+    if (winW == 0 || winH == 0) return;
+    uint32_t n = (uint32_t)winW * winH;
+    int16_t x = winX + winPos % winW;
+    int16_t y = winY + (winPos / winW) % winH;
+    winPos = (winPos + 1) % n;
+    if (x < _width && y < _height) frame[y * _width + x] = color;
+}
+
+void Adafruit_SPITFT::writePixels(uint16_t* colors, uint32_t len, bool block, bool bigEndian) {
+    (void)block;
+    (void)bigEndian;  // Byte order only matters on the wire
+    for (uint32_t i = 0; i < len; i++) putPixel(colors[i]);
+}
+
+void Adafruit_SPITFT::writeColor(uint16_t color, uint32_t len) {
+    for (uint32_t i = 0; i < len; i++) putPixel(color);
+}
+
+void Adafruit_SPITFT::sendCommand(uint8_t cmd, const uint8_t* data, uint8_t len) {
+    if (cmd == 0x37 && len >= 2) scrollStart = (data[0] << 8) | data[1];  // VSCSAD
+}
+
+void Adafruit_SPITFT::drawPixel(int16_t x, int16_t y, uint16_t color) {
+    if (x < 0 || y < 0 || x >= _width || y >= _height) return;
+    startWrite();
+    setAddrWindow(x, y, 1, 1);
+    writeColor(color, 1);
+    endWrite();
+}
+
+void Adafruit_SPITFT::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    if (w < 0) { x += w + 1; w = -w; }
+    if (h < 0) { y += h + 1; h = -h; }
+    int16_t x1 = x + w, y1 = y + h;
+    if (x < 0) x = 0;
+    if (y < 0) y = 0;
+    if (x1 > _width) x1 = _width;
+    if (y1 > _height) y1 = _height;
+    if (x >= x1 || y >= y1) return;
+    startWrite();
+    setAddrWindow(x, y, x1 - x, y1 - y);
+    writeColor(color, (uint32_t)(x1 - x) * (y1 - y));
+    endWrite();
+}
+
+void Adafruit_SPITFT::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+    fillRect(x, y, w, 1, color);
+}
+
+void Adafruit_SPITFT::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+    fillRect(x, y, 1, h, color);
+}
+
+uint16_t Adafruit_SPITFT::hostPixel(int16_t x, int16_t y) const {
+    if (x < 0 || y < 0 || x >= _width || y >= _height) return 0;
+    return frame[y * _width + x];
+}
+
+// The ST7735 scrolls along its gate lines: panel line n shows frame row
+// (start + n). The whole panel is the scroll area, as disp.cpp sets it up.
+// MADCTL maps frame rows to screen y (rotation 2), 159 - y (0), x (3) or
+// 159 - x (1); each mapping is its own inverse.
+uint16_t Adafruit_SPITFT::hostScreenPixel(int16_t x, int16_t y) const {
+    if (x < 0 || y < 0 || x >= _width || y >= _height) return 0;
+    bool alongX = rotation & 1;
+    bool mirrored = rotation == 0 || rotation == 1;
+    int16_t lines = alongX ? _width : _height;
+    int16_t line = alongX ? x : y;
+    int16_t row = mirrored ? lines - 1 - line : line;
+    row = (row + scrollStart) % lines;
+    line = mirrored ? lines - 1 - row : row;
+    return alongX ? hostPixel(line, y) : hostPixel(x, line);
+}
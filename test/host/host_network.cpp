@@ -0,0 +1,11 @@
+#include <SPI.h>
+#include <WiFi.h>
+
+// Peripherals and fetch status the display code refers to. The fetch code
+// itself is not built on the host.
+SPIClass SPI;
+WiFiClass WiFi;
+
+int getLastHttpCode() { return 0; }
+int getLastHtmlSize() { return 0; }
+int getLastFoundEntries() { return 0; }
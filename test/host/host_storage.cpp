@@ -0,0 +1,62 @@
+#include <Preferences.h>
+#include <esp_now.h>
+#include <map>
+
+// Preferences: one map of blobs, keyed "namespace/key"
+static std::map<std::string, std::string> nvs;
+
+bool Preferences::begin(const char* name, bool ro) {
+    ns = name;
+    open = true;
+    readOnly = ro;
+    return true;
+}
+
+void Preferences::end() {
+    open = false;
+}
+
+size_t Preferences::putBytes(const char* key, const void* value, size_t len) {
+    if (!open || readOnly) return 0;
+    nvs[ns + "/" + key].assign(static_cast<const char*>(value), len);
+    return len;
+}
+
+size_t Preferences::getBytes(const char* key, void* buf, size_t maxLen) {
+    auto it = nvs.find(ns + "/" + key);
+    if (!open || it == nvs.end() || it->second.size() > maxLen) return 0;
+    memcpy(buf, it->second.data(), it->second.size());
+    return it->second.size();
+}
+
+size_t Preferences::getBytesLength(const char* key) {
+    auto it = nvs.find(ns + "/" + key);
+    return open && it != nvs.end() ? it->second.size() : 0;
+}
+
+void hostPreferencesClear() {
+    nvs.clear();
+}
+
+// ESP-NOW: the registered receive callback
+static esp_now_recv_cb_t recvCallback = nullptr;
+
+esp_err_t esp_now_init() {
+    return ESP_OK;
+}
+
+esp_err_t esp_now_register_recv_cb(esp_now_recv_cb_t cb) {
+    recvCallback = cb;
+    return ESP_OK;
+}
+
+esp_err_t esp_now_unregister_recv_cb() {
+    recvCallback = nullptr;
+    return ESP_OK;
+}
+
+bool hostEspNowDeliver(const uint8_t* mac, const uint8_t* data, int len) {
+    if (recvCallback == nullptr) return false;
+    recvCallback(mac, data, len);
+    return true;
+}
@@ -0,0 +1,91 @@
+// Host stand-in for the subset_fonts.h that scripts/font_subset.py generates
+// from the Adafruit fonts: seven-segment glyphs of about the same size, in
+// the same run-length format, so native tests draw the large digits
+// through the real decoder without the Adafruit GFX library.
+#ifndef SUBSET_FONTS_H
+#define SUBSET_FONTS_H
+#include "subset_font.h"
+
+// 0123456789NOW-
+static const uint8_t FreeSansBold18pt7bSubsetData[] = {
+    160, 64, 0, 68, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8,
+    8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8,
+    8, 8, 8, 68, 12, 4, 12, 4, 12, 4, 12, 4, 12, 4, 12, 4,
+    12, 4, 12, 4, 12, 4, 12, 4, 12, 4, 12, 4, 12, 4, 12, 4,
+    12, 4, 12, 4, 12, 4, 12, 4, 12, 4, 12, 4, 12, 4, 12, 4,
+    12, 4, 12, 4, 0, 64, 12, 4, 12, 4, 12, 4, 12, 4, 12, 4,
+    12, 72, 12, 4, 12, 4, 12, 4, 12, 4, 12, 4, 12, 64, 0, 64,
+    12, 4, 12, 4, 12, 4, 12, 4, 12, 4, 12, 68, 12, 4, 12, 4,
+    12, 4, 12, 4, 12, 4, 12, 68, 0, 4, 8, 8, 8, 8, 8, 8,
+    8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 68, 12, 4,
+    12, 4, 12, 4, 12, 4, 12, 4, 12, 4, 12, 4, 12, 4, 12, 4,
+    12, 4, 0, 68, 12, 4, 12, 4, 12, 4, 12, 4, 12, 4, 12, 64,
+    12, 4, 12, 4, 12, 4, 12, 4, 12, 4, 12, 68, 0, 68, 12, 4,
+    12, 4, 12, 4, 12, 4, 12, 4, 12, 68, 8, 8, 8, 8, 8, 8,
+    8, 8, 8, 8, 8, 68, 0, 64, 12, 4, 12, 4, 12, 4, 12, 4,
+    12, 4, 12, 4, 12, 4, 12, 4, 12, 4, 12, 4, 12, 4, 12, 4,
+    12, 4, 12, 4, 12, 4, 12, 4, 12, 4, 12, 4, 12, 4, 12, 4,
+    0, 68, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 72, 8, 8,
+    8, 8, 8, 8, 8, 8, 8, 8, 8, 68, 0, 68, 8, 8, 8, 8,
+    8, 8, 8, 8, 8, 8, 8, 68, 12, 4, 12, 4, 12, 4, 12, 4,
+    12, 4, 12, 68, 0, 4, 8, 8, 8, 9, 7, 9, 7, 10, 6, 10,
+    6, 11, 5, 11, 5, 12, 4, 12, 4, 8, 1, 4, 3, 8, 1, 4,
+    3, 8, 2, 4, 2, 8, 2, 4, 2, 8, 3, 4, 1, 8, 3, 4,
+    1, 8, 4, 12, 4, 12, 5, 11, 5, 11, 6, 10, 6, 10, 7, 9,
+    7, 5, 0, 68, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8,
+    8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8,
+    8, 8, 8, 68, 0, 4, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8,
+    8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 2, 4,
+    2, 8, 2, 4, 2, 8, 2, 4, 2, 8, 2, 4, 2, 8, 2, 4,
+    2, 8, 2, 4, 2, 8, 2, 4, 2, 8, 2, 4, 2, 68,
+};
+static const SubsetGlyph FreeSansBold18pt7bSubsetGlyphs[] = {
+    { 0, 2, '-', 16, 24, 19, 1, -24 },
+    { 2, 34, '0', 16, 24, 19, 1, -24 },
+    { 36, 48, '1', 16, 24, 19, 1, -24 },
+    { 84, 26, '2', 16, 24, 19, 1, -24 },
+    { 110, 26, '3', 16, 24, 19, 1, -24 },
+    { 136, 42, '4', 16, 24, 19, 1, -24 },
+    { 178, 26, '5', 16, 24, 19, 1, -24 },
+    { 204, 26, '6', 16, 24, 19, 1, -24 },
+    { 230, 42, '7', 16, 24, 19, 1, -24 },
+    { 272, 26, '8', 16, 24, 19, 1, -24 },
+    { 298, 26, '9', 16, 24, 19, 1, -24 },
+    { 324, 62, 'N', 16, 24, 19, 1, -24 },
+    { 386, 34, 'O', 16, 24, 19, 1, -24 },
+    { 420, 58, 'W', 16, 24, 19, 1, -24 },
+};
+static const SubsetFont FreeSansBold18pt7bSubset = { FreeSansBold18pt7bSubsetData, FreeSansBold18pt7bSubsetGlyphs, 14, 32 };
+
+// 0123456789-
+static const uint8_t FreeSansBold12pt7bSubsetData[] = {
+    77, 33, 0, 36, 5, 6, 5, 6, 5, 6, 5, 6, 5, 6, 5, 6,
+    5, 6, 5, 6, 5, 6, 5, 36, 8, 3, 8, 3, 8, 3, 8, 3,
+    8, 3, 8, 3, 8, 3, 8, 3, 8, 3, 8, 3, 8, 3, 8, 3,
+    8, 3, 8, 3, 8, 3, 8, 3, 0, 33, 8, 3, 8, 3, 8, 3,
+    8, 39, 8, 3, 8, 3, 8, 33, 0, 33, 8, 3, 8, 3, 8, 3,
+    8, 36, 8, 3, 8, 3, 8, 36, 0, 3, 5, 6, 5, 6, 5, 6,
+    5, 6, 5, 6, 5, 6, 5, 36, 8, 3, 8, 3, 8, 3, 8, 3,
+    8, 3, 8, 3, 0, 36, 8, 3, 8, 3, 8, 3, 8, 33, 8, 3,
+    8, 3, 8, 36, 0, 36, 8, 3, 8, 3, 8, 3, 8, 36, 5, 6,
+    5, 6, 5, 36, 0, 33, 8, 3, 8, 3, 8, 3, 8, 3, 8, 3,
+    8, 3, 8, 3, 8, 3, 8, 3, 8, 3, 8, 3, 8, 3, 8, 3,
+    0, 36, 5, 6, 5, 6, 5, 6, 5, 39, 5, 6, 5, 6, 5, 36,
+    0, 36, 5, 6, 5, 6, 5, 6, 5, 36, 8, 3, 8, 3, 8, 36,
+};
+static const SubsetGlyph FreeSansBold12pt7bSubsetGlyphs[] = {
+    { 0, 2, '-', 11, 16, 13, 1, -16 },
+    { 2, 22, '0', 11, 16, 13, 1, -16 },
+    { 24, 32, '1', 11, 16, 13, 1, -16 },
+    { 56, 16, '2', 11, 16, 13, 1, -16 },
+    { 72, 16, '3', 11, 16, 13, 1, -16 },
+    { 88, 28, '4', 11, 16, 13, 1, -16 },
+    { 116, 16, '5', 11, 16, 13, 1, -16 },
+    { 132, 16, '6', 11, 16, 13, 1, -16 },
+    { 148, 28, '7', 11, 16, 13, 1, -16 },
+    { 176, 16, '8', 11, 16, 13, 1, -16 },
+    { 192, 16, '9', 11, 16, 13, 1, -16 },
+};
+static const SubsetFont FreeSansBold12pt7bSubset = { FreeSansBold12pt7bSubsetData, FreeSansBold12pt7bSubsetGlyphs, 11, 24 };
+
+#endif
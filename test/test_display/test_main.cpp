@@ -0,0 +1,219 @@
+// Renders the board into the host framebuffer (test/host) and compares the
+// frames with the golden PPMs in golden/. A mismatch writes the frame that
+// was drawn to actual/ for a side-by-side look.
+// Run with: pio test -e native -f test_display
+// Refresh the goldens after an intended layout change with UPDATE_GOLDEN=1.
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <sys/stat.h>
+#include "config.h"
+#include "disp.h"
+#include "str_pool.h"
+
+static const time_t BOARD_TIME = 1772439300;  // 2026-03-02 08:15:00 UTC
+
+static std::string testDir() {
+    std::string file = __FILE__;
+    return file.substr(0, file.find_last_of('/') + 1);
+}
+
+static std::string framePpm() {
+    std::string ppm = "P6\n160 128\n255\n";
+    for (int16_t y = 0; y < 128; y++) {
+        for (int16_t x = 0; x < 160; x++) {
+            uint16_t c = tft->hostScreenPixel(x, y);
+            uint8_t r = (c >> 11) & 0x1F, g = (c >> 5) & 0x3F, b = c & 0x1F;
+            ppm += (char)((r << 3) | (r >> 2));
+            ppm += (char)((g << 2) | (g >> 4));
+            ppm += (char)((b << 3) | (b >> 2));
+        }
+    }
+    return ppm;
+}
+
+static bool readFile(const std::string& path, std::string& out) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (f == nullptr) return false;
+    char buf[4096];
+    size_t n;
+    out.clear();
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) out.append(buf, n);
+    fclose(f);
+    return true;
+}
+
+static void writeFile(const std::string& path, const std::string& data) {
+    FILE* f = fopen(path.c_str(), "wb");
+    if (f == nullptr) return;
+    fwrite(data.data(), 1, data.size(), f);
+    fclose(f);
+}
+
+static void assertMatchesGolden(const char* name) {
+    std::string frame = framePpm();
+    std::string golden = testDir() + "golden/" + name + ".ppm";
+    if (getenv("UPDATE_GOLDEN") != nullptr) {
+        writeFile(golden, frame);
+        return;
+    }
+
+    std::string expected;
+    if (!readFile(golden, expected) || expected.size() != frame.size()) {
+        TEST_FAIL_MESSAGE(("missing or malformed " + golden + ", run with UPDATE_GOLDEN=1").c_str());
+    }
+    int differing = 0;
+    for (size_t i = frame.size() - 160 * 128 * 3; i < frame.size(); i += 3) {
+        if (frame.compare(i, 3, expected, i, 3) != 0) differing++;
+    }
+    if (differing > 0) {
+        std::string dir = testDir() + "actual/";
+        mkdir(dir.c_str(), 0755);
+        writeFile(dir + name + ".ppm", frame);
+        char msg[160];
+        snprintf(msg, sizeof(msg), "%s: %d pixels differ, frame written to %s%s.ppm", name, differing, dir.c_str(), name);
+        TEST_FAIL_MESSAGE(msg);
+    }
+}
+
+static void addTram(DepartureTable& table, const char* line, const char* dest, int minutes) {
+    Tram& t = table.trams[table.count++];
+    t.line = internString(line);
+    t.dest = internString(dest);
+    t.departs = BOARD_TIME + minutes * 60;
+}
+
+static SensorCell sensorCell(const char* name, int soil, int battery, bool fresh) {
+    SensorCell cell = {};
+    cell.name = name;
+    cell.data.soilMoisture = soil;
+    cell.data.batteryPercent = battery;
+    cell.fresh = fresh;
+    return cell;
+}
+
+void setUp() {
+    static bool ready = false;
+    if (ready) return;
+    setenv("TZ", "UTC0", 1);
+    tzset();
+    hostSetTime(BOARD_TIME);
+    initDisplay();
+    ready = true;
+}
+void tearDown() {}
+
+static void boardWithWeatherAndSensors(DepartureTable& trams, Weather& weather, SensorCell* cells) {
+    trams = {};
+    addTram(trams, "17", "Wateringen", 3);
+    addTram(trams, "17", "Wateringen", 11);
+    addTram(trams, "17", "Centraal Station", 18);
+    addTram(trams, "17", "Wateringen", 26);
+    weather = { 12.4f, 7.0f, 14.6f, 4.2f, "clouds", true };
+    cells[0] = sensorCell("Olga", 45, 87, true);
+    cells[1] = sensorCell("A&E", 0, 0, false);
+    // A day drying out from 70% with a night of missed readings, then a stale
+    // sensor's last few hours
+    for (int h = 0; h < BOARD_TREND_POINTS; h++) {
+        cells[0].trend[h] = h >= 8 && h < 12 ? HISTORY_NO_DATA : 70 - h;
+        cells[1].trend[h] = h < 20 ? HISTORY_NO_DATA : 30;
+    }
+    cells[0].trendPoints = cells[1].trendPoints = BOARD_TREND_POINTS;
+    cells[2] = SensorCell{};
+}
+
+static void boardLeavingNow(DepartureTable& trams, Weather& weather, SensorCell* cells) {
+    trams = {};
+    addTram(trams, "17", "Wateringen", 0);
+    addTram(trams, "17", "Wateringen", 9);
+    weather = {};
+    for (int i = 0; i < BOARD_SENSOR_CELLS; i++) cells[i] = SensorCell{};
+}
+
+static void test_board_matches_golden() {
+    DepartureTable trams;
+    Weather weather;
+    SensorCell cells[BOARD_SENSOR_CELLS];
+    boardWithWeatherAndSensors(trams, weather, cells);
+    showMessage("Golden");  // Any other screen makes the next board a full paint
+    TEST_ASSERT_TRUE(showTramsWithWeatherAndSensor(trams, weather, cells, 0, 2));
+    assertMatchesGolden("board");
+}
+
+static void test_board_now_matches_golden() {
+    DepartureTable trams;
+    Weather weather;
+    SensorCell cells[BOARD_SENSOR_CELLS];
+    boardLeavingNow(trams, weather, cells);
+    showMessage("Golden");
+    TEST_ASSERT_TRUE(showTramsWithWeatherAndSensor(trams, weather, cells, 0, 1));
+    assertMatchesGolden("board_now");
+}
+
+// The older quadrant layout with one sensor
+static void test_sensor_quadrants_match_golden() {
+    DepartureTable trams = {};
+    addTram(trams, "17", "Wateringen", 3);
+    addTram(trams, "17", "Wateringen", 11);
+    addTram(trams, "17", "Centraal Station", 18);
+    addTram(trams, "17", "Wateringen", 26);
+    sensor_data_t olga = { 3.9f, 87, 45, 0 };
+    showTramsWithSensor(trams, olga);
+    assertMatchesGolden("sensor_quadrants");
+}
+
+// Redrawing only the changed widgets must end on the same frame as a full paint
+static void test_partial_update_equals_full_paint() {
+    DepartureTable trams;
+    Weather weather;
+    SensorCell cells[BOARD_SENSOR_CELLS];
+
+    boardWithWeatherAndSensors(trams, weather, cells);
+    showMessage("Golden");
+    showTramsWithWeatherAndSensor(trams, weather, cells, 0, 2);
+    boardLeavingNow(trams, weather, cells);
+    TEST_ASSERT_TRUE(showTramsWithWeatherAndSensor(trams, weather, cells, 0, 1));
+    assertMatchesGolden("board_now");
+
+    // Same content again: nothing to draw
+    TEST_ASSERT_FALSE(showTramsWithWeatherAndSensor(trams, weather, cells, 0, 1));
+}
+
+// Scrolling draws one entering column per step; after a while the panel
+// must show what a full redraw at the same position paints
+static void test_scrolled_list_equals_full_redraw() {
+    DepartureTable trams = {};
+    addTram(trams, "17", "Wateringen", 3);
+    addTram(trams, "17", "Centraal Station", 11);
+    addTram(trams, "9", "Scheveningen Noorderstrand", 18);
+    addTram(trams, "17", "Wateringen", 26);
+    DepartureTable other = trams;
+    other.trams[0].departs += 60;
+
+    showMessage("Golden");
+    TEST_ASSERT_TRUE(showTrams(trams));
+    assertMatchesGolden("list");
+
+    for (int i = 0; i < 50; i++) {
+        delay(TRAM_SCROLL_FRAME_MS);
+        tickTramScroll();
+    }
+    TEST_ASSERT_NOT_EQUAL(0, tft->hostScrollStart());
+    std::string scrolled = framePpm();
+
+    // New content redraws every column in place, keeping the scroll position
+    TEST_ASSERT_TRUE(showTrams(other));
+    TEST_ASSERT_TRUE(showTrams(trams));
+    TEST_ASSERT_TRUE(scrolled == framePpm());
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_board_matches_golden);
+    RUN_TEST(test_board_now_matches_golden);
+    RUN_TEST(test_sensor_quadrants_match_golden);
+    RUN_TEST(test_partial_update_equals_full_paint);
+    RUN_TEST(test_scrolled_list_equals_full_redraw);
+    return UNITY_END();
+}
@@ -0,0 +1,368 @@
+// Host tests for the SWAR scanners and the incremental DRGL parser, and a
+// benchmark of the scanners against the String loop they replaced.
+// Run with: pio test -e native -f test_drgl_parser
+#include <unity.h>
+#include <chrono>
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "drgl_parser.h"
+#include "swar_scan.h"
+
+struct Row {
+    std::string time, line, dest;
+};
+
+static bool collect(const DrglRecord& rec, void* ctx) {
+    static_cast<std::vector<Row>*>(ctx)->push_back({rec.time, rec.line, rec.dest});
+    return true;
+}
+
+// Byte-at-a-time reference for the page grammar the parser implements
+static std::vector<Row> referenceParse(const std::string& html) {
+    std::vector<Row> out;
+    size_t pos = 0;
+    auto skip = [&] {
+        while (pos < html.size() && (isspace((unsigned char)html[pos]) || html[pos] == '<')) {
+            if (html[pos] == '<') {
+                while (pos < html.size() && html[pos] != '>') pos++;
+            }
+            pos++;
+        }
+    };
+    while (pos < html.size()) {
+        size_t t = pos;
+        while (t + 4 < html.size() &&
+               !(isdigit((unsigned char)html[t]) && isdigit((unsigned char)html[t + 1]) && html[t + 2] == ':' &&
+                 isdigit((unsigned char)html[t + 3]) && isdigit((unsigned char)html[t + 4]))) {
+            t++;
+        }
+        if (t + 4 >= html.size()) break;
+        Row r{html.substr(t, 5), "", ""};
+        pos = t + 5;
+        skip();
+        while (pos < html.size() && isdigit((unsigned char)html[pos])) r.line += html[pos++];
+        skip();
+        while (pos < html.size() && html[pos] != '<' && html[pos] != '\n' && html[pos] != '\r' &&
+               r.dest.size() < DRGL_MAX_DEST) {
+            r.dest += html[pos++];
+        }
+        while (!r.dest.empty() && isspace((unsigned char)r.dest.back())) r.dest.pop_back();
+        if (r.line.size() <= DRGL_MAX_LINE) out.push_back(r);
+    }
+    return out;
+}
+
+// Feed html in random chunks of 1..maxChunk bytes
+static std::vector<Row> parseChunked(const std::string& html, size_t maxChunk, DrglParser* out = nullptr) {
+    std::vector<Row> rows;
+    DrglParser p;
+    drglParserInit(p, collect, &rows);
+    size_t i = 0;
+    while (i < html.size()) {
+        size_t n = 1 + rand() % maxChunk;
+        if (i + n > html.size()) n = html.size() - i;
+        drglParserFeed(p, html.data() + i, n);
+        i += n;
+    }
+    drglParserFinish(p);
+    if (out) *out = p;
+    return rows;
+}
+
+static std::string randomPage(int pieces) {
+    static const char* frags[] = {"<td>", "</td>", "12:34", " ", "\n", "17", "12345", "Wateringen",
+                                  "<a href=\"https://x\">", "Den Haag Centraal", "9:5", "1:23:45",
+                                  "<span class=x>", "x", ">", "  "};
+    const int count = sizeof(frags) / sizeof(frags[0]);
+    std::string html;
+    for (int k = 0; k < pieces; k++) html += frags[rand() % count];
+    if (rand() % 3 == 0) html += std::string(70, 'a');
+    return html;
+}
+
+void setUp() {}
+void tearDown() {}
+
+static void test_swar_matches_naive_scan() {
+    srand(1);
+    char buf[96];
+    for (int it = 0; it < 20000; it++) {
+        size_t off = rand() % 8;
+        size_t n = rand() % (sizeof(buf) - off);
+        for (size_t k = 0; k < sizeof(buf); k++) {
+            static const char alphabet[] = "0123456789:<>\n\r ab";
+            buf[k] = alphabet[rand() % (sizeof(alphabet) - 1)];
+        }
+        const char* p = buf + off;
+
+        size_t byteAt = n, anyAt = n, timeAt = n;
+        for (size_t k = 0; k < n && byteAt == n; k++) if (p[k] == '>') byteAt = k;
+        for (size_t k = 0; k < n && anyAt == n; k++) if (p[k] == '<' || p[k] == '\n' || p[k] == '\r') anyAt = k;
+        for (size_t k = 0; k + 5 <= n && timeAt == n; k++) {
+            if (isdigit((unsigned char)p[k]) && isdigit((unsigned char)p[k + 1]) && p[k + 2] == ':' &&
+                isdigit((unsigned char)p[k + 3]) && isdigit((unsigned char)p[k + 4])) {
+                timeAt = k;
+            }
+        }
+        TEST_ASSERT_EQUAL(byteAt, swarFindByte(p, n, '>'));
+        TEST_ASSERT_EQUAL(anyAt, swarFindAny3(p, n, '<', '\n', '\r'));
+        TEST_ASSERT_EQUAL(timeAt, swarFindTime(p, n));
+    }
+}
+
+static void test_parser_matches_reference_across_chunk_splits() {
+    srand(3);
+    for (int it = 0; it < 3000; it++) {
+        std::string html = randomPage(rand() % 200);
+        std::vector<Row> expected = referenceParse(html);
+        std::vector<Row> got = parseChunked(html, (it % 2) ? 17 : 300);
+        TEST_ASSERT_EQUAL(expected.size(), got.size());
+        for (size_t k = 0; k < expected.size(); k++) {
+            TEST_ASSERT_EQUAL_STRING(expected[k].time.c_str(), got[k].time.c_str());
+            TEST_ASSERT_EQUAL_STRING(expected[k].line.c_str(), got[k].line.c_str());
+            TEST_ASSERT_EQUAL_STRING(expected[k].dest.c_str(), got[k].dest.c_str());
+        }
+    }
+}
+
+static void test_overlong_line_is_rejected_not_truncated() {
+    // "12345" must not come out as line 1234
+    std::string html = "<td>12:00</td><td>12345</td><td>Delft</td>\n"
+                       "<td>12:05</td><td>1234</td><td>Delft</td>\n";
+    DrglParser p;
+    std::vector<Row> rows = parseChunked(html, 3, &p);
+    TEST_ASSERT_EQUAL(1, rows.size());
+    TEST_ASSERT_EQUAL_STRING("12:05", rows[0].time.c_str());
+    TEST_ASSERT_EQUAL_STRING("1234", rows[0].line.c_str());
+    TEST_ASSERT_EQUAL(1, p.rejected);
+    TEST_ASSERT_EQUAL(0, p.filtered);
+}
+
+static void test_filters_drop_rows_inside_parser() {
+    std::string html = "<td>12:00</td><td>17</td><td>Wateringen</td>\n"
+                       "<td>12:01</td><td>1</td><td>Delft Tanthof</td>\n"
+                       "<td>12:02</td><td>17</td><td>Centraal Station</td>\n";
+    std::vector<Row> rows;
+    DrglParser p;
+    drglParserInit(p, collect, &rows);
+    drglParserSetFilter(p, "17", "Water");
+    drglParserFeed(p, html.data(), html.size());
+    drglParserFinish(p);
+    TEST_ASSERT_EQUAL(1, rows.size());
+    TEST_ASSERT_EQUAL_STRING("Wateringen", rows[0].dest.c_str());
+    TEST_ASSERT_EQUAL(2, p.filtered);
+    TEST_ASSERT_EQUAL(0, p.rejected);
+}
+
+// ===== The scan fetchTrams() did before the SWAR scanners =====
+
+// Just enough of the ESP32 core's String for that loop: 11 characters
+// inline, then a heap buffer grown to the exact length on every append,
+// and a bounds-checked operator[] that lives out of line in WString.cpp.
+class CoreString {
+public:
+    CoreString(const char* s = "") { assign(s, strlen(s)); }
+    explicit CoreString(char c) { assign(&c, 1); }
+    CoreString(const CoreString& o) { assign(o.c_str(), o.len); }
+    CoreString& operator=(const CoreString& o) {
+        if (this != &o) { len = 0; assign(o.c_str(), o.len); }
+        return *this;
+    }
+    ~CoreString() { if (heap) free(heap); }
+
+    __attribute__((noinline)) char operator[](unsigned index) const {
+        return index < len ? c_str()[index] : 0;
+    }
+    unsigned length() const { return len; }
+    const char* c_str() const { return heap ? heap : sso; }
+
+    CoreString& operator+=(char c) { append(&c, 1); return *this; }
+    friend CoreString operator+(const CoreString& a, const CoreString& b) {
+        CoreString r(a);
+        r.append(b.c_str(), b.len);
+        return r;
+    }
+    friend CoreString operator+(const CoreString& a, const char* b) {
+        CoreString r(a);
+        r.append(b, strlen(b));
+        return r;
+    }
+
+private:
+    static const unsigned SSO = 11;
+    char sso[SSO + 1] = {};
+    char* heap = nullptr;
+    unsigned len = 0;
+
+    void assign(const char* s, unsigned n) { append(s, n); }
+    __attribute__((noinline)) void append(const char* s, unsigned n) {
+        unsigned need = len + n;
+        if (need > SSO) {
+            bool wasInline = heap == nullptr;
+            char* grown = (char*)realloc(heap, need + 1);  // reserve(): exactly what is needed
+            if (wasInline) memcpy(grown, sso, len);
+            heap = grown;
+        }
+        char* buf = heap ? heap : sso;
+        memcpy(buf + len, s, n);
+        len = need;
+        buf[len] = 0;
+    }
+};
+
+// Port of the per-offset time search: five operator[] calls per offset
+// and the time glued together from single-character Strings
+static size_t stringLoopTimes(const CoreString& html, char (*out)[6], size_t max) {
+    size_t count = 0;
+    int pos = 0;
+    while (pos < (int)html.length() && count < max) {
+        bool foundTime = false;
+        CoreString timeStr = "";
+        for (int i = pos; i < (int)html.length() - 4; i++) {
+            char c1 = html[i];
+            char c2 = html[i + 1];
+            char c3 = html[i + 2];
+            char c4 = html[i + 3];
+            char c5 = html[i + 4];
+            if (isdigit(c1) && isdigit(c2) && c3 == ':' && isdigit(c4) && isdigit(c5)) {
+                timeStr = CoreString(c1) + CoreString(c2) + ":" + CoreString(c4) + CoreString(c5);
+                pos = i + 5;
+                foundTime = true;
+                break;
+            }
+        }
+        if (!foundTime) break;
+        memcpy(out[count++], timeStr.c_str(), 6);
+    }
+    return count;
+}
+
+static size_t swarTimes(const char* p, size_t n, char (*out)[6], size_t max) {
+    size_t count = 0, pos = 0;
+    while (pos < n && count < max) {
+        size_t at = pos + swarFindTime(p + pos, n - pos);
+        if (at >= n) break;
+        memcpy(out[count], p + at, 5);
+        out[count++][5] = '\0';
+        pos = at + 5;
+    }
+    return count;
+}
+
+// Port of the destination copy: one operator[] and one append per character
+static size_t stringLoopDest(const CoreString& html, int pos, char* out) {
+    CoreString dest = "";
+    while (pos < (int)html.length() && html[pos] != '<' && html[pos] != '\n' &&
+           html[pos] != '\r' && dest.length() < 50) {
+        dest += html[pos];
+        pos++;
+    }
+    memcpy(out, dest.c_str(), dest.length() + 1);
+    return dest.length();
+}
+
+static size_t swarDest(const char* p, size_t n, size_t pos, char* out) {
+    size_t span = n - pos < 50 ? n - pos : 50;
+    size_t len = swarFindAny3(p + pos, span, '<', '\n', '\r');
+    memcpy(out, p + pos, len);
+    out[len] = '\0';
+    return len;
+}
+
+#define STOP_PAGE "test/test_drgl_parser/drgl_stop_page.html"
+#define STOP_PAGE_DEPARTURES 48
+
+static std::string loadStopPage() {
+    std::string html;
+    FILE* f = fopen(STOP_PAGE, "rb");
+    if (!f) return html;
+    char buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) html.append(buf, n);
+    fclose(f);
+    return html;
+}
+
+template <typename F>
+static double secondsFor(int rounds, F f) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+static void test_stop_page_parses_every_departure() {
+    const std::string html = loadStopPage();
+    TEST_ASSERT_TRUE_MESSAGE(!html.empty(), "run from the project root: " STOP_PAGE);
+    std::vector<Row> expected = referenceParse(html);
+    std::vector<Row> got = parseChunked(html, 512);
+    TEST_ASSERT_EQUAL(STOP_PAGE_DEPARTURES, got.size());
+    TEST_ASSERT_EQUAL(expected.size(), got.size());
+    for (size_t k = 0; k < got.size(); k++) {
+        TEST_ASSERT_EQUAL_STRING(expected[k].time.c_str(), got[k].time.c_str());
+        TEST_ASSERT_EQUAL_STRING(expected[k].dest.c_str(), got[k].dest.c_str());
+    }
+}
+
+// swarFindTime and swarFindAny3 against the String loops they replaced,
+// on the stop page. Prints both rates and the ratio; only the results
+// are asserted, so slow hosts do not fail the suite.
+static void test_scanners_against_string_loop() {
+    const std::string html = loadStopPage();
+    TEST_ASSERT_TRUE_MESSAGE(!html.empty(), "run from the project root: " STOP_PAGE);
+    const CoreString page(html.c_str());
+    const int rounds = 300;
+    char msg[128];
+
+    static char loopOut[64][6], swarOut[64][6];
+    size_t loopCount = 0, swarCount = 0;
+    double loopS = secondsFor(rounds, [&] { loopCount = stringLoopTimes(page, loopOut, 64); });
+    double swarS = secondsFor(rounds, [&] { swarCount = swarTimes(html.data(), html.size(), swarOut, 64); });
+    TEST_ASSERT_EQUAL(STOP_PAGE_DEPARTURES, loopCount);
+    TEST_ASSERT_EQUAL(loopCount, swarCount);
+    TEST_ASSERT_EQUAL_MEMORY(loopOut, swarOut, sizeof(loopOut[0]) * loopCount);
+    double mb = (double)rounds * html.size() / 1e6;
+    snprintf(msg, sizeof(msg), "time search: String loop %.1f MB/s, swarFindTime %.1f MB/s (%.1fx)",
+             mb / loopS, mb / swarS, loopS / swarS);
+    TEST_MESSAGE(msg);
+
+    // Every destination on the page, from the first byte after its tag
+    static const char marker[] = "class=\"ott-destination\">";
+    std::vector<size_t> starts;
+    for (size_t at = html.find(marker); at != std::string::npos; at = html.find(marker, at + 1)) {
+        starts.push_back(at + sizeof(marker) - 1);
+    }
+    TEST_ASSERT_EQUAL(STOP_PAGE_DEPARTURES, starts.size());
+    char loopDest[64], swarDestBuf[64];
+    size_t loopBytes = 0, swarBytes = 0;
+    for (size_t s : starts) {
+        TEST_ASSERT_EQUAL(stringLoopDest(page, s, loopDest), swarDest(html.data(), html.size(), s, swarDestBuf));
+        TEST_ASSERT_EQUAL_STRING(loopDest, swarDestBuf);
+    }
+    const int destRounds = rounds * 20;
+    loopS = secondsFor(destRounds, [&] {
+        for (size_t s : starts) loopBytes += stringLoopDest(page, s, loopDest);
+    });
+    swarS = secondsFor(destRounds, [&] {
+        for (size_t s : starts) swarBytes += swarDest(html.data(), html.size(), s, swarDestBuf);
+    });
+    TEST_ASSERT_EQUAL(loopBytes, swarBytes);
+    snprintf(msg, sizeof(msg), "destination copy: String loop %.0f ns, swarFindAny3 %.0f ns per departure (%.1fx)",
+             loopS * 1e9 / ((double)destRounds * starts.size()), swarS * 1e9 / ((double)destRounds * starts.size()),
+             loopS / swarS);
+    TEST_MESSAGE(msg);
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_swar_matches_naive_scan);
+    RUN_TEST(test_parser_matches_reference_across_chunk_splits);
+    RUN_TEST(test_overlong_line_is_rejected_not_truncated);
+    RUN_TEST(test_filters_drop_rows_inside_parser);
+    RUN_TEST(test_stop_page_parses_every_departure);
+    RUN_TEST(test_scanners_against_string_loop);
+    return UNITY_END();
+}
@@ -0,0 +1,143 @@
+// Receive path under load, on the host: a producer thread plays the radio
+// into the registered callback at each of LOADGEN_RATES while this thread
+// drains the queue like the main loop. Every frame must be either applied
+// or counted as dropped.
+// Run with: pio test -e native -f test_espnow_rx
+#include <unity.h>
+#include <atomic>
+#include <chrono>
+#include <stdio.h>
+#include <thread>
+#include <esp_now.h>
+#include "espnow_receiver.h"
+#include "sensor_wire.h"
+
+#define RX_SENDERS 24
+#define RX_READINGS 4
+#define RX_STEP_MS 1000  // Per rate; the device runs LOADGEN_SECONDS
+
+// Same MACs as the load generator's senders
+static void senderMac(uint16_t sender, uint8_t* mac) {
+    mac[0] = (LOADGEN_MAC_PREFIX >> 16) & 0xFF;
+    mac[1] = (LOADGEN_MAC_PREFIX >> 8) & 0xFF;
+    mac[2] = LOADGEN_MAC_PREFIX & 0xFF;
+    mac[3] = 0x00;
+    mac[4] = sender >> 8;
+    mac[5] = sender & 0xFF;
+}
+
+static size_t buildFrame(uint8_t* frame, uint16_t sender, uint16_t sequence) {
+    SensorWireReading readings[RX_READINGS];
+    for (int i = 0; i < RX_READINGS; i++) {
+        readings[i].batteryMv = 3600 + (sequence + sender) % 500;
+        readings[i].batteryPercent = 50 + (sequence + sender) % 50;
+        readings[i].moisturePermille = (sequence * 7 + sender * 13 + i) % 1000;
+        readings[i].ageSeconds = (RX_READINGS - 1 - i) * 60;
+    }
+    return sensorWireEncode(frame, SENSOR_WIRE_MAX_FRAME, sequence,
+                            sequence == 0 ? SENSOR_WIRE_FLAG_BOOT : 0, readings, RX_READINGS);
+}
+
+// Send at `rate` frames per second for RX_STEP_MS, round robin over the
+// senders: every millisecond whatever is due, like the load generator
+static void playRadio(uint32_t rate, std::atomic<uint32_t>& sent, std::atomic<bool>& done) {
+    static uint16_t sequences[RX_SENDERS];
+    uint8_t mac[6];
+    uint8_t frame[SENSOR_WIRE_MAX_FRAME];
+    auto start = std::chrono::steady_clock::now();
+    auto next = start;
+    uint32_t n = 0;
+    for (;;) {
+        uint32_t elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(next - start).count();
+        if (elapsed >= RX_STEP_MS) break;
+        for (uint32_t due = (uint64_t)rate * elapsed / 1000; n < due; n++) {
+            uint16_t sender = n % RX_SENDERS;
+            senderMac(sender, mac);
+            size_t len = buildFrame(frame, sender, sequences[sender]++);
+            hostEspNowDeliver(mac, frame, len);
+        }
+        next += std::chrono::milliseconds(1);
+        std::this_thread::sleep_until(next);
+    }
+    sent.store(n);
+    done.store(true);
+}
+
+void setUp() {
+    static bool ready = false;
+    if (ready) return;
+    initESPNowReceiver();
+    ready = true;
+}
+void tearDown() {}
+
+// Each rate of LOADGEN_RATES for RX_STEP_MS. Drops depend on how the host
+// schedules the two threads, so they are reported, not asserted.
+static void test_every_frame_is_applied_or_counted_as_dropped() {
+    const uint32_t rates[] = LOADGEN_RATES;
+    for (uint32_t rate : rates) {
+        EspNowStats before = getEspNowStats();
+        resetEspNowPeaks();
+
+        std::atomic<uint32_t> sent{0};
+        std::atomic<bool> done{false};
+        std::thread radio(playRadio, rate, std::ref(sent), std::ref(done));
+        while (!done.load()) {
+            processSensorPackets();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));  // Rest of a loop() pass
+        }
+        radio.join();
+        processSensorPackets();
+
+        EspNowStats after = getEspNowStats();
+        uint32_t received = after.received - before.received;
+        uint32_t dropped = after.dropped - before.dropped;
+        uint32_t processed = after.processed - before.processed;
+        char msg[200];
+        snprintf(msg, sizeof(msg),
+                 "%u fps from %d senders: sent %u, applied %u, dropped %u, max queue %u; "
+                 "callback p50 <%u us, p99 <%u us; main loop %.2f us/frame",
+                 (unsigned)rate, RX_SENDERS, (unsigned)sent.load(), (unsigned)processed, (unsigned)dropped,
+                 (unsigned)after.maxQueueDepth, (unsigned)after.callbackP50Us, (unsigned)after.callbackP99Us,
+                 processed > 0 ? (double)(after.processUs - before.processUs) / processed : 0.0);
+        TEST_MESSAGE(msg);
+
+        TEST_ASSERT_EQUAL(sent.load(), received + dropped);
+        TEST_ASSERT_EQUAL(received, processed);
+        TEST_ASSERT_EQUAL(0, after.rejected - before.rejected);
+        TEST_ASSERT_TRUE(after.maxQueueDepth <= ESPNOW_QUEUE_SIZE);
+        // A dropped frame only skips sequence numbers; nothing is seen twice or late
+        TEST_ASSERT_EQUAL(before.duplicates, after.duplicates);
+        TEST_ASSERT_EQUAL(before.reordered, after.reordered);
+    }
+    TEST_ASSERT_EQUAL(2 + RX_SENDERS, getEspNowStats().sensors);  // SENSOR_NAMES has two
+}
+
+// The load generator feeds onDataRecv itself; the radio must be off meanwhile
+static void test_detached_radio_delivers_nothing() {
+    uint8_t mac[6];
+    uint8_t frame[SENSOR_WIRE_MAX_FRAME];
+    senderMac(0, mac);
+    size_t len = buildFrame(frame, 0, 1);
+
+    detachEspNowRadio();
+    TEST_ASSERT_FALSE(hostEspNowDeliver(mac, frame, len));
+    attachEspNowRadio();
+    TEST_ASSERT_TRUE(hostEspNowDeliver(mac, frame, len));
+    processSensorPackets();
+}
+
+static void test_peaks_start_over() {
+    resetEspNowPeaks();
+    EspNowStats stats = getEspNowStats();
+    TEST_ASSERT_EQUAL(0, stats.maxQueueDepth);
+    TEST_ASSERT_EQUAL(0, stats.callbackMaxUs);
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_every_frame_is_applied_or_counted_as_dropped);
+    RUN_TEST(test_detached_radio_delivers_nothing);
+    RUN_TEST(test_peaks_start_over);
+    return UNITY_END();
+}
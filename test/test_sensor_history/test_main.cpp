@@ -0,0 +1,83 @@
+// Sensor history: buckets keep an exact average however many readings land
+// in them, short windows come from the raw readings, and a sensor past
+// HISTORY_SENSORS takes the slot of the one heard from longest ago.
+// Run with: pio test -e native -f test_sensor_history
+#include <unity.h>
+#include "sensor_history.h"
+
+static const time_t DAY = 86400;
+static const time_t T0 = 1760000000 / DAY * DAY;  // Midnight, 2025-10-09
+
+void setUp() {}
+void tearDown() {}
+
+static void record(uint64_t mac, time_t at, int moisture) {
+    sensor_data_t data = { 3.9f, 80, moisture, 0 };
+    recordSensorHistory(mac, data, at);
+}
+
+static void test_full_day_in_one_bucket() {
+    // A reading every two minutes: 720 in the day, sum 72000
+    const uint64_t mac = 0x80F1B2500001ull;
+    for (int i = 0; i < 720; i++) record(mac, T0 + i * 120, 100);
+
+    uint8_t week[7];
+    TEST_ASSERT_EQUAL(7, sensorSparkline(mac, HISTORY_MOISTURE, 7 * DAY, T0 + DAY, week, 7));
+    TEST_ASSERT_EQUAL(100, week[6]);
+    TEST_ASSERT_EQUAL(HISTORY_NO_DATA, week[0]);
+}
+
+static void test_busy_hour_in_one_bucket() {
+    // 300 readings in one hour: 200 dry, then 100 wet
+    const uint64_t mac = 0x80F1B2500002ull;
+    time_t start = T0 + 2 * DAY;
+    for (int i = 0; i < 300; i++) record(mac, start + i * 12, i < 200 ? 10 : 70);
+
+    uint8_t day[24];
+    TEST_ASSERT_EQUAL(24, sensorSparkline(mac, HISTORY_MOISTURE, DAY, start + 3600, day, 24));
+    TEST_ASSERT_EQUAL((200 * 10 + 100 * 70) / 300, day[23]);
+}
+
+static void test_short_window_uses_raw_readings() {
+    // All in one hourly bucket, which would average them to 20
+    const uint64_t mac = 0x80F1B2500003ull;
+    time_t now = T0 + 3 * DAY + 1800;
+    record(mac, now - 1500, 10);
+    record(mac, now - 900, 20);
+    record(mac, now - 300, 30);
+
+    uint8_t points[3];
+    TEST_ASSERT_EQUAL(3, sensorSparkline(mac, HISTORY_MOISTURE, 1800, now, points, 3));
+    TEST_ASSERT_EQUAL(10, points[0]);
+    TEST_ASSERT_EQUAL(20, points[1]);
+    TEST_ASSERT_EQUAL(30, points[2]);
+}
+
+static void test_new_sensor_takes_oldest_slot() {
+    // Newer than anything above, so these fill the slots in order
+    const uint64_t first = 0x80F1B2500100ull;
+    time_t now = T0 + 4 * DAY;
+    for (int i = 0; i <= HISTORY_SENSORS; i++) record(first + i, now + i * 60, 40 + i);
+
+    uint8_t point;
+    time_t later = now + 3600;
+    TEST_ASSERT_EQUAL(0, sensorSparkline(first, HISTORY_MOISTURE, 3600, later, &point, 1));
+    for (int i = 1; i <= HISTORY_SENSORS; i++) {
+        TEST_ASSERT_EQUAL(1, sensorSparkline(first + i, HISTORY_MOISTURE, 3600, later, &point, 1));
+        TEST_ASSERT_EQUAL(40 + i, point);
+    }
+
+    // Back again: its history was saved when it lost the slot
+    record(first, later, 60);
+    TEST_ASSERT_EQUAL(1, sensorSparkline(first, HISTORY_MOISTURE, 7200, later + 1, &point, 1));
+    TEST_ASSERT_EQUAL(50, point);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_full_day_in_one_bucket);
+    RUN_TEST(test_busy_hour_in_one_bucket);
+    RUN_TEST(test_short_window_uses_raw_readings);
+    RUN_TEST(test_new_sensor_takes_oldest_slot);
+    return UNITY_END();
+}
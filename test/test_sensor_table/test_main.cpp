@@ -0,0 +1,200 @@
+// Sensor table with dozens of sensors: every one is found with its latest
+// reading, the table refuses sensors past 3/4 full, and lookups and updates
+// are timed against the two std::maps the table replaced. Also covers how
+// frame sequence numbers are accepted and how made-up senders are kept out
+// of flash and removed again.
+// Run with: pio test -e native -f test_sensor_table
+#include <unity.h>
+#include <chrono>
+#include <map>
+#include <stdio.h>
+#include <Preferences.h>
+#include <esp_now.h>
+#include "espnow_receiver.h"
+#include "sensor_wire.h"
+
+// The load generator's prefix: made-up senders, so the registry and history
+// stay out of it, with the low bytes of a batch of real sensors
+static const uint64_t BENCH_PREFIX = (uint64_t)LOADGEN_MAC_PREFIX << 24;
+static const uint32_t DEFAULT_SENSORS = 2;  // SENSOR_NAMES in config.h
+static const uint32_t BENCH_SENSORS = SENSOR_TABLE_SIZE * 3 / 4 - DEFAULT_SENSORS;
+
+static uint64_t benchMac(uint32_t i) {
+    return BENCH_PREFIX | (0x502900 + i * 7);
+}
+
+static void deliver(uint64_t mac, int soil) {
+    uint8_t addr[6];
+    for (int i = 0; i < 6; i++) addr[i] = (uint8_t)(mac >> (40 - 8 * i));
+    sensor_data_t data = { 3.9f, 80, soil, 0 };
+    hostEspNowDeliver(addr, (const uint8_t*)&data, sizeof(data));
+}
+
+// Deliver one reading per sensor, draining the ring before it overflows
+static void deliverRound(int soilBase) {
+    for (uint32_t i = 0; i < BENCH_SENSORS; i++) {
+        deliver(benchMac(i), (soilBase + i) % 100);
+        if ((i + 1) % ESPNOW_QUEUE_SIZE == 0) processSensorPackets();
+    }
+    processSensorPackets();
+}
+
+void setUp() {
+    static bool ready = false;
+    if (ready) return;
+    initESPNowReceiver();
+    ready = true;
+}
+void tearDown() {}
+
+static void test_every_sensor_is_found_with_its_reading() {
+    deliverRound(0);
+    deliverRound(40);
+    TEST_ASSERT_EQUAL(DEFAULT_SENSORS + BENCH_SENSORS, sensorCountRegistered());
+    for (uint32_t i = 0; i < BENCH_SENSORS; i++) {
+        const SensorState* sensor = findSensor(benchMac(i));
+        TEST_ASSERT_NOT_NULL(sensor);
+        TEST_ASSERT_EQUAL((40 + i) % 100, sensor->data.soilMoisture);
+        TEST_ASSERT_EQUAL(2, sensor->packets);
+    }
+    TEST_ASSERT_NULL(findSensor(BENCH_PREFIX | 0xFFFFFF));
+}
+
+static void test_table_refuses_sensors_past_three_quarters() {
+    uint32_t refused = getEspNowStats().sensorsRefused;
+    deliver(BENCH_PREFIX | 0xFFFFFE, 50);
+    processSensorPackets();
+    TEST_ASSERT_EQUAL(refused + 1, getEspNowStats().sensorsRefused);
+    TEST_ASSERT_NULL(findSensor(BENCH_PREFIX | 0xFFFFFE));
+    TEST_ASSERT_EQUAL(DEFAULT_SENSORS + BENCH_SENSORS, sensorCountRegistered());
+}
+
+// The board used to ask the maps three times per cell: has, data, age
+static void test_lookup_and_update_speed() {
+    std::map<uint64_t, sensor_data_t> mapData;
+    std::map<uint64_t, unsigned long> mapTime;
+    for (uint32_t i = 0; i < BENCH_SENSORS; i++) {
+        mapData[benchMac(i)] = sensor_data_t{ 3.9f, 80, (int)i, 0 };
+        mapTime[benchMac(i)] = i;
+    }
+    const int rounds = 20000;
+    const double lookups = (double)rounds * BENCH_SENSORS;
+
+    auto t0 = std::chrono::steady_clock::now();
+    long sum = 0;
+    for (int r = 0; r < rounds; r++) {
+        for (uint32_t i = 0; i < BENCH_SENSORS; i++) {
+            const SensorState* sensor = findSensor(benchMac(i));
+            sum += sensor->data.soilMoisture + sensor->lastSeen;
+        }
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    long mapSum = 0;
+    for (int r = 0; r < rounds; r++) {
+        for (uint32_t i = 0; i < BENCH_SENSORS; i++) {
+            uint64_t mac = benchMac(i);
+            if (mapData.count(mac) == 0) continue;
+            mapSum += mapData[mac].soilMoisture + mapTime[mac];
+        }
+    }
+    auto t2 = std::chrono::steady_clock::now();
+
+    // Update: the whole receive path (callback, ring, table) against two map stores
+    const int updateRounds = 2000;
+    const double updates = (double)updateRounds * BENCH_SENSORS;
+    for (int r = 0; r < updateRounds; r++) deliverRound(r);
+    auto t3 = std::chrono::steady_clock::now();
+    for (int r = 0; r < updateRounds; r++) {
+        for (uint32_t i = 0; i < BENCH_SENSORS; i++) {
+            uint64_t mac = benchMac(i);
+            mapData[mac] = sensor_data_t{ 3.9f, 80, (int)((r + i) % 100), 0 };
+            mapTime[mac] = r;
+        }
+    }
+    auto t4 = std::chrono::steady_clock::now();
+
+    char msg[160];
+    snprintf(msg, sizeof(msg), "%u sensors: lookup %.1f ns (maps %.1f ns), receive path %.1f ns per frame (map stores %.1f ns)",
+             (unsigned)BENCH_SENSORS,
+             std::chrono::duration<double, std::nano>(t1 - t0).count() / lookups,
+             std::chrono::duration<double, std::nano>(t2 - t1).count() / lookups,
+             std::chrono::duration<double, std::nano>(t3 - t2).count() / updates,
+             std::chrono::duration<double, std::nano>(t4 - t3).count() / updates);
+    TEST_MESSAGE(msg);
+
+    TEST_ASSERT_TRUE(sum > 0 && mapSum > 0);
+    TEST_ASSERT_EQUAL(0, getEspNowStats().dropped);
+}
+
+static void deliverFrame(uint64_t mac, uint16_t sequence, uint16_t moisturePermille) {
+    uint8_t addr[6];
+    for (int i = 0; i < 6; i++) addr[i] = (uint8_t)(mac >> (40 - 8 * i));
+    SensorWireReading reading = { 3900, 80, moisturePermille, 0 };
+    uint8_t frame[SENSOR_WIRE_MAX_FRAME];
+    size_t len = sensorWireEncode(frame, sizeof(frame), sequence, 0, &reading, 1);
+    hostEspNowDeliver(addr, frame, len);
+    processSensorPackets();
+}
+
+// A restart whose BOOT frame was lost must not leave the sensor muted
+// until its new sequence overtakes the old one
+static void test_sequence_far_behind_is_taken_as_restart() {
+    uint64_t mac = benchMac(0);
+    EspNowStats before = getEspNowStats();
+    deliverFrame(mac, 500, 400);
+    deliverFrame(mac, 500, 410);  // Retry of the same frame
+    deliverFrame(mac, 499, 420);  // Overtaken by 500
+    TEST_ASSERT_EQUAL(40, findSensor(mac)->data.soilMoisture);
+
+    deliverFrame(mac, 3, 300);    // Rebooted, BOOT frame lost
+    TEST_ASSERT_EQUAL(30, findSensor(mac)->data.soilMoisture);
+    deliverFrame(mac, 4, 310);
+    TEST_ASSERT_EQUAL(31, findSensor(mac)->data.soilMoisture);
+
+    EspNowStats after = getEspNowStats();
+    TEST_ASSERT_EQUAL(before.duplicates + 1, after.duplicates);
+    TEST_ASSERT_EQUAL(before.reordered + 1, after.reordered);
+    TEST_ASSERT_EQUAL(before.resynced + 1, after.resynced);
+}
+
+static const uint64_t REAL_MAC = 0x80F1B2502974ull;  // First of SENSOR_NAMES
+
+static void test_registry_in_flash_holds_only_real_sensors() {
+    TEST_ASSERT_TRUE(setSensorName(REAL_MAC, "Basil"));
+    Preferences prefs;
+    prefs.begin("sensors", true);
+    size_t len = prefs.getBytesLength("registry");
+    prefs.end();
+    // Two real sensors of a MAC and a name each, not the 46 made-up ones
+    TEST_ASSERT_TRUE(len > 0 && len <= 2 * (sizeof(uint64_t) + SENSOR_NAME_LEN + 8));
+}
+
+static void test_eviction_removes_made_up_senders_only() {
+    evictSyntheticSensors();
+    TEST_ASSERT_EQUAL(DEFAULT_SENSORS + BENCH_SENSORS, sensorCountRegistered());  // Not before the next pass
+    processSensorPackets();
+
+    TEST_ASSERT_EQUAL(DEFAULT_SENSORS, sensorCountRegistered());
+    TEST_ASSERT_EQUAL(REAL_MAC, sensorAt(0)->mac);
+    TEST_ASSERT_EQUAL_STRING("Basil", sensorAt(0)->name);
+    TEST_ASSERT_EQUAL(0x80F1B2502948ull, sensorAt(1)->mac);
+    for (uint32_t i = 0; i < BENCH_SENSORS; i++) TEST_ASSERT_NULL(findSensor(benchMac(i)));
+
+    // Probe chains survived the removals: the freed slots fill up again
+    deliverRound(7);
+    TEST_ASSERT_EQUAL(DEFAULT_SENSORS + BENCH_SENSORS, sensorCountRegistered());
+    for (uint32_t i = 0; i < BENCH_SENSORS; i++) {
+        TEST_ASSERT_EQUAL((7 + i) % 100, findSensor(benchMac(i))->data.soilMoisture);
+    }
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_every_sensor_is_found_with_its_reading);
+    RUN_TEST(test_table_refuses_sensors_past_three_quarters);
+    RUN_TEST(test_lookup_and_update_speed);
+    RUN_TEST(test_sequence_far_behind_is_taken_as_restart);
+    RUN_TEST(test_registry_in_flash_holds_only_real_sensors);
+    RUN_TEST(test_eviction_removes_made_up_senders_only);
+    return UNITY_END();
+}
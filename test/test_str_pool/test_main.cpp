@@ -0,0 +1,101 @@
+// Host tests for the intern pool and its mark-and-sweep.
+// Run with: pio test -e native -f test_str_pool
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include "str_pool.h"
+
+static uint8_t ids[STR_POOL_ENTRIES];
+
+// Empty the pool: a sweep with nothing marked frees everything
+void setUp() {
+    strPoolBeginSweep();
+    strPoolSweep();
+}
+void tearDown() {}
+
+static void test_same_string_same_id() {
+    uint8_t a = internString("Wateringen");
+    uint8_t b = internString("Delft");
+    TEST_ASSERT_EQUAL(a, internString("Wateringen"));
+    TEST_ASSERT_TRUE(a != b);
+    TEST_ASSERT_EQUAL_STRING("Delft", pooledString(b));
+}
+
+static void test_full_pool_refuses_and_asks_for_sweep() {
+    char name[16];
+    for (int i = 0; i < STR_POOL_ENTRIES; i++) {
+        snprintf(name, sizeof(name), "stop %d", i);
+        ids[i] = internString(name);
+        TEST_ASSERT_TRUE(ids[i] != STR_NONE);
+    }
+    TEST_ASSERT_TRUE(strPoolWantsSweep());
+    TEST_ASSERT_EQUAL(STR_NONE, internString("one too many"));
+    TEST_ASSERT_EQUAL_STRING("?", pooledString(STR_NONE));
+}
+
+static void test_sweep_keeps_marked_ids_and_frees_the_rest() {
+    char name[16];
+    for (int i = 0; i < STR_POOL_ENTRIES; i++) {
+        snprintf(name, sizeof(name), "stop %d", i);
+        ids[i] = internString(name);
+    }
+
+    // Keep every third string; their ids must survive the compaction
+    strPoolBeginSweep();
+    for (int i = 0; i < STR_POOL_ENTRIES; i += 3) strPoolMark(ids[i]);
+    strPoolSweep();
+    TEST_ASSERT_FALSE(strPoolWantsSweep());
+
+    for (int i = 0; i < STR_POOL_ENTRIES; i++) {
+        snprintf(name, sizeof(name), "stop %d", i);
+        if (i % 3 == 0) {
+            TEST_ASSERT_EQUAL_STRING(name, pooledString(ids[i]));
+            TEST_ASSERT_EQUAL(ids[i], internString(name));
+        } else {
+            TEST_ASSERT_EQUAL_STRING("?", pooledString(ids[i]));
+        }
+    }
+
+    // Freed slots take new names again
+    uint8_t fresh = internString("Den Haag Centraal");
+    TEST_ASSERT_TRUE(fresh != STR_NONE);
+    TEST_ASSERT_EQUAL_STRING("Den Haag Centraal", pooledString(fresh));
+}
+
+static void test_sweep_reclaims_bytes() {
+    // Long names exhaust the bytes before the entries
+    char name[64];
+    memset(name, 'x', sizeof(name) - 1);
+    name[sizeof(name) - 1] = '\0';
+    uint8_t kept = STR_NONE;
+    int stored = 0;
+    for (int i = 0; i < STR_POOL_ENTRIES; i++) {
+        name[0] = 'A' + i;
+        uint8_t id = internString(name);
+        if (id == STR_NONE) break;
+        if (i == 2) kept = id;
+        stored++;
+    }
+    TEST_ASSERT_TRUE(stored < STR_POOL_ENTRIES);
+
+    strPoolBeginSweep();
+    strPoolMark(kept);
+    strPoolSweep();
+
+    name[0] = 'C';
+    TEST_ASSERT_EQUAL_STRING(name, pooledString(kept));
+    for (int i = 0; i < stored - 1; i++) {
+        name[0] = 'a' + i;
+        TEST_ASSERT_TRUE(internString(name) != STR_NONE);
+    }
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_same_string_same_id);
+    RUN_TEST(test_full_pool_refuses_and_asks_for_sweep);
+    RUN_TEST(test_sweep_keeps_marked_ids_and_frees_the_rest);
+    RUN_TEST(test_sweep_reclaims_bytes);
+    return UNITY_END();
+}